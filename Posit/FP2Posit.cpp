@@ -0,0 +1,161 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "FP2Posit.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	FP2Posit::FP2Posit(Target* target, int N, int es, int wE, int wF, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), wE(wE), wF(wF), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="FP2Posit";
+
+		if(wE < 2 || wF < 1)
+			THROWERROR("the IEEE format needs wE >= 2 and wF >= 1, got wE=" << wE << " wF=" << wF);
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "FP2Posit_" << N << "_" << es << "_" << wE << "_" << wF;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		int bias = (1 << (wE-1)) - 1;
+		// signed, from the smallest subnormal 2^(1-bias-wF) to the largest normal, and at least what PositEncoder needs
+		wSF = max(max(intlog2(bias+wF), wE) + 1, RegSize+es);
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Input", 1+wE+wF);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of FP2Posit \n");
+		REPORT(DETAILED, "this operator has received four parameters " << N << ", " << es << ", " << wE << " and " << wF);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		vhdl << tab << declare("sign") << " <= Input" << of(wE+wF) << ";" << endl;
+		vhdl << tab << declare("E", wE) << " <= Input" << range(wE+wF-1, wF) << ";" << endl;
+		vhdl << tab << declare("F", wF) << " <= Input" << range(wF-1, 0) << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(wE+wF) + target->lutDelay());
+		addComment("Infinities and NaNs become NaR, both zeros 0");
+		vhdl << tab << declare("inf") << " <= '1' when E = " << og(wE) << " else '0';" << endl;
+		vhdl << tab << declare("z") << " <= '1' when Input" << range(wE+wF-1, 0) << " = 0 else '0';" << endl;
+		vhdl << tab << declare("normal") << " <= '0' when E = 0 else '1';" << endl;
+		vhdl << tab << declare("mant", wF+1) << " <= normal & F;" << endl;
+
+	//=========================================================================|
+		addFullComment("Normalization of subnormals");
+	// ========================================================================|
+		vhdl << tab << declare("zero_var") << " <= '0';" << endl;
+		LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(wF+1), "I=>mant;OZB=>zero_var;O=>lzc");
+		syncCycleFromSignal("lzc");
+		setCriticalPath(lzc->getOutputDelay("O"));
+		int wL = getSignalByName("lzc")->width();
+
+		Shifter* normShifter = (Shifter*) newInstance("Shifter", "NormShifter", "wIn=" + to_string(wF+1) + " maxShift=" + to_string(wF+1) + " dir=0", "X=>mant;S=>lzc;R=>norm_out");
+		syncCycleFromSignal("norm_out");
+		setCriticalPath(normShifter->getOutputDelay("R"));
+		addComment("The leading one of the significand at frac_n'high");
+		vhdl << tab << declare("frac_n", wF+1) << " <= norm_out" << range(wF, 0) << ";" << endl;
+
+		addComment("A subnormal has the exponent of the smallest normal, less its leading zeros");
+		vhdl << tab << declare("e_eff", wE) << " <= E when normal = '1' else \"" << unsignedBinary(mpz_class(1), wE) << "\";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+		vhdl << tab << declare("sf", wSF) << " <= (" << zg(wSF-wE) << " & e_eff) - " << bias << " - (" << zg(wSF-wL) << " & lzc);" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF) + " wF=" + to_string(wF+1), "Sign=>sign;SF=>sf;Frac=>frac_n;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	void FP2Posit::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "Input" );
+		tc->addExpectedOutput ( "Output", model.fromIEEE(svX, wE, wF) );
+	}
+
+
+	TestCase* FP2Posit::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		mpz_class expOnes = (mpz_class(1) << wE) - 1;
+		mpz_class e;
+		if(i % 4 == 0)
+			// anywhere, subnormals and specials included
+			e = getLargeRandom(wE);
+		else {
+			// scale factors up to one regime beyond maxpos and minpos, to exercise saturation
+			mpz_class range = mpz_class(N) << es;
+			e = getLargeRandom(wSF+8) % (2*range+1) - range + ((1 << (wE-1)) - 1);
+			if(e < 0)
+				e = 0;
+			if(e > expOnes)
+				e = expOnes;
+		}
+		mpz_class x = (getLargeRandom(1) << (wE+wF)) | (e << wF) | getLargeRandom(wF);
+		tc->addInput("Input", x);
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr FP2Posit::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int wE;
+		UserInterface::parseStrictlyPositiveInt(args, "wE", &wE);
+		int wF;
+		UserInterface::parseStrictlyPositiveInt(args, "wF", &wF);
+		return new FP2Posit(target, N, es, wE, wF);
+	}
+
+
+	void FP2Posit::registerFactory(){
+		UserInterface::add("FP2Posit", // name
+											 "A conversion from IEEE-754 to posit, rounded to nearest even.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "Posit2FP,PositEncoder", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=16: The output size; \
+                        					 es(int): The exponent size; \
+                        					 wE(int)=8: The exponent size of the IEEE input; \
+                        					 wF(int)=23: The fraction size of the IEEE input",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "wE=8 wF=23 is binary32, wE=8 wF=7 bfloat16. Subnormals are converted, infinities and NaNs become NaR.",
+											 FP2Posit::parseArguments
+											 ) ;
+	}
+
+}//namespace
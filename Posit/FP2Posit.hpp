@@ -0,0 +1,85 @@
+/*
+  IEEE-754 to posit conversion.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef FP_2_POSIT_HPP
+#define FP_2_POSIT_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** Conversion of an IEEE-754 number with wE exponent and wF fraction bits
+	    to an N-bit posit, rounded to nearest even as PositMult rounds.
+	    Subnormals are normalised by a leading zero count, and the scale factor
+	    and significand are packed by PositEncoder, which also saturates to
+	    minpos and maxpos. Infinities and NaNs become NaR. */
+	class FP2Posit : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** The exponent and fraction widths of the IEEE format */
+		int wE;
+		int wF;
+
+		int RegSize;
+		/** Width of the scale factor given to the encoder */
+		int wSF;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param wE The exponent width of the IEEE format.
+		    * @param wF The fraction width of the IEEE format.
+		    */
+		FP2Posit(Target* target, int N = 16, int es = 1, int wE = 8, int wF = 23, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~FP2Posit() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   Most exponents fall in the range of the posits */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,155 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "PositDecoder.hpp"
+
+// include the header of the Operator
+#include "Posit2FP.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	Posit2FP::Posit2FP(Target* target, int N, int es, int wE, int wF, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), wE(wE), wF(wF), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="Posit2FP";
+
+		if(wE < 2 || wF < 1)
+			THROWERROR("the IEEE format needs wE >= 2 and wF >= 1, got wE=" << wE << " wF=" << wF);
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "Posit2FP_" << N << "_" << es << "_" << wE << "_" << wF;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Input", N);
+		addOutput ( "Output", 1+wE+wF);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of Posit2FP \n");
+		REPORT(DETAILED, "this operator has received four parameters " << N << ", " << es << ", " << wE << " and " << wF);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		PositDecoder* decoder = (PositDecoder*) newInstance("PositDecoder", "decoder", "N=" + to_string(N) + " es=" + to_string(es), "Input=>Input;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z;inf=>inf");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoder->getOutputDelay("Reg"));
+
+		addComment("Gather scale factor");
+		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+		if (es>0) vhdl << " & exp_A";
+		vhdl << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Biased exponent and subnormal alignment");
+	// ========================================================================|
+		int bias = (1 << (wE-1)) - 1;
+		// signed, and wide enough to compare with 2^wE-1
+		int wB = max(RegSize+es, wE+1) + 1;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wB));
+		vhdl << tab << declare("e_b", wB) << " <= ((" << wB-1 << " downto " << RegSize+es << " => sf_A(sf_A'high)) & sf_A) + " << bias << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(wB) + target->lutDelay());
+		addComment("A biased exponent below 1 gives a subnormal, above 2^wE-2 an infinity");
+		vhdl << tab << declare("sub") << " <= '1' when e_b(e_b'high) = '1' or e_b = 0 else '0';" << endl;
+		vhdl << tab << declare("ovf") << " <= '1' when sub = '0' and e_b >= " << (1 << wE) - 1 << " else '0';" << endl;
+
+		// Beyond wF+2 the whole significand is below the guard bit
+		int maxShift = wF+2;
+		int ws = intlog2(maxShift);
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wB) + target->lutDelay());
+		addComment("A subnormal is shifted right by 1-e_b");
+		vhdl << tab << declare("s_raw", wB) << " <= 1 - e_b;" << endl;
+		vhdl << tab << declare("sh", ws) << " <= " << zg(ws) << " when sub = '0' else "
+								<< "\"" << unsignedBinary(mpz_class(maxShift), ws) << "\" when s_raw > " << maxShift << " else "
+								<< "s_raw" << range(ws-1, 0) << ";" << endl;
+
+		Shifter* rightShifter = (Shifter*) newInstance("Shifter", "RightShifterComponent", "wIn=" + to_string(FracSize) + " maxShift=" + to_string(maxShift) + " dir=1", "X=>frac_A;S=>sh;R=>frac_sh");
+		syncCycleFromSignal("frac_sh");
+		setCriticalPath(rightShifter->getOutputDelay("R"));
+		int W = FracSize + maxShift;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		addComment("The hidden bit, at frac_sh'high for a normal, is dropped");
+		vhdl << tab << declare("kept", wF) << " <= frac_sh" << range(W-2, W-wF-1) << ";" << endl;
+		vhdl << tab << declare("LSB") << " <= frac_sh" << of(W-wF-1) << ";" << endl;
+		vhdl << tab << declare("G") << " <= frac_sh" << of(W-wF-2) << ";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(W-wF-2) + target->lutDelay());
+		vhdl << tab << declare("S") << " <= '0' when frac_sh" << range(W-wF-3, 0) << " = 0 else '1';" << endl;
+		vhdl << tab << declare("round") << " <= G AND (LSB OR S);" << endl;
+
+		vhdl << tab << declare("e_field", wE) << " <= " << zg(wE) << " when sub = '1' else e_b" << range(wE-1, 0) << ";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+wF));
+		addComment("The rounding carry may reach the exponent: smallest normal, or infinity");
+		vhdl << tab << declare("rounded", wE+wF) << " <= (e_field & kept) + round;" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		vhdl << tab << "Output <= \"" << unsignedBinary(model.toIEEE(mpz_class(1) << (N-1), wE, wF), 1+wE+wF) << "\" when inf = '1' else "
+											<< zg(1+wE+wF) << " when z = '1' else "
+											<< "sign_A & \"" << unsignedBinary(((mpz_class(1) << wE) - 1) << wF, wE+wF) << "\" when ovf = '1' else "
+											<< "sign_A & rounded;" << endl;
+	};
+
+
+	void Posit2FP::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "Input" );
+		tc->addExpectedOutput ( "Output", model.toIEEE(svX, wE, wF) );
+	}
+
+
+	OperatorPtr Posit2FP::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int wE;
+		UserInterface::parseStrictlyPositiveInt(args, "wE", &wE);
+		int wF;
+		UserInterface::parseStrictlyPositiveInt(args, "wF", &wF);
+		return new Posit2FP(target, N, es, wE, wF);
+	}
+
+
+	void Posit2FP::registerFactory(){
+		UserInterface::add("Posit2FP", // name
+											 "A conversion from posit to IEEE-754, rounded to nearest even.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "FP2Posit,PositDecoder", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=16: The input size; \
+                        					 es(int): The exponent size; \
+                        					 wE(int)=8: The exponent size of the IEEE output; \
+                        					 wF(int)=23: The fraction size of the IEEE output",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "wE=8 wF=23 is binary32, wE=8 wF=7 bfloat16. Subnormals are produced, NaR becomes a quiet NaN.",
+											 Posit2FP::parseArguments
+											 ) ;
+	}
+
+}//namespace
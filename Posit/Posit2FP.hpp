@@ -0,0 +1,81 @@
+/*
+  Posit to IEEE-754 conversion.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_2_FP_HPP
+#define POSIT_2_FP_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** Conversion of an N-bit posit to an IEEE-754 number with wE exponent and
+	    wF fraction bits, rounded to nearest even.
+	    The posit is unpacked by PositDecoder; a scale factor below the normal
+	    range shifts the significand right into a subnormal, and the rounding
+	    carry propagates through the exponent field, so that it also yields the
+	    smallest normal and infinity. NaR becomes a quiet NaN. */
+	class Posit2FP : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** The exponent and fraction widths of the IEEE format */
+		int wE;
+		int wF;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param wE The exponent width of the IEEE format.
+		    * @param wF The fraction width of the IEEE format.
+		    */
+		Posit2FP(Target* target, int N = 16, int es = 1, int wE = 8, int wF = 23, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~Posit2FP() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
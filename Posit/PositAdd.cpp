@@ -0,0 +1,255 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositAdd.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositAdd::PositAdd(Target* target, int N, int es, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositAdd";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositAdd_" << N << "_" << es;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "InputA", N);
+		addInput  ( "InputB", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositAdd \n");
+		REPORT(DETAILED, "this operator has received two parameters " << N << " and " << es);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		string decParams = "N=" + to_string(N) + " es=" + to_string(es);
+		PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", decParams, "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+		PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", decParams, "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoderA->getOutputDelay("Reg"));
+		syncCycleFromSignal("reg_B");
+		setCriticalPath(decoderB->getOutputDelay("Reg"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+
+		addComment("Gather scale factors");
+		for(string op : {"A", "B"}) {
+			vhdl << tab << declare("sf_" + op, RegSize+es) << " <= reg_" << op;
+			if (es>0) vhdl << " & exp_" << op;
+			vhdl << ";" << endl;
+		}
+
+	//=========================================================================|
+		addFullComment("Sign and Special Cases Computation");
+	// ========================================================================|
+
+		vhdl << tab << declare("inf") << " <= inf_A OR inf_B;" << endl;
+		vhdl << tab << declare("eff_sub") << " <= sign_A XOR sign_B;" << endl;
+
+	//=========================================================================|
+		addFullComment("Order the operands by magnitude");
+	// ========================================================================|
+		// The significands are on W bits with the hidden bit on top
+		int wE = RegSize+es;
+		int W = FracSize;
+
+		addComment("Scale factor then significand, the sign of the scale factor inverted for an unsigned comparison");
+		for(string op : {"A", "B"})
+			vhdl << tab << declare("key_" + op, wE+W) << " <= (NOT sf_" << op << "(sf_" << op << "'high)) & sf_" << op << range(wE-2, 0) << " & frac_" << op << ";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+W));
+		addComment("X is the operand of larger magnitude, a zero operand being always Y");
+		vhdl << tab << declare("swap") << " <= '1' when z_A = '1' or (z_B = '0' and key_A < key_B) else '0';" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		vhdl << tab << declare("sig_X", W) << " <= frac_B when swap = '1' else frac_A;" << endl;
+		vhdl << tab << declare("sig_Y", W) << " <= " << zg(W) << " when (z_A OR z_B) = '1' else"
+										<< " frac_A when swap = '1' else frac_B;" << endl;
+		vhdl << tab << declare("sf_X", wE) << " <= sf_B when swap = '1' else sf_A;" << endl;
+		vhdl << tab << declare("sf_Y", wE) << " <= sf_A when swap = '1' else sf_B;" << endl;
+		vhdl << tab << declare("sign") << " <= sign_B when swap = '1' else sign_A;" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+1));
+		addComment("Non-negative, unless Y is zero");
+		vhdl << tab << declare("sf_diff", wE+1) << " <= (sf_X(sf_X'high) & sf_X) - (sf_Y(sf_Y'high) & sf_Y);" << endl;
+		vhdl << tab << declare("close") << " <= eff_sub when sf_diff = 0 or sf_diff = 1 else '0';" << endl;
+
+		// The scale factor of the sum: that of X, plus one, minus the cancellation of the close path,
+		// counted by a LZOC on W+1 bits
+		int lzcSize = intlog2(W+1);
+		int wSF = max(wE, lzcSize+1) + 1;
+		vhdl << tab << declare("sf_X_ext", wSF) << " <= (" << wSF-1 << " downto " << wE << " => sf_X(sf_X'high)) & sf_X;" << endl;
+		double cpSplit = getCriticalPath();
+
+	//=========================================================================|
+		addFullComment("Far path: alignment of Y with a sticky bit, at most one bit of normalization");
+	// ========================================================================|
+		// Y is shifted right into W+2 extra bits: beyond that it is far below the
+		// rounding point, and only matters as a nonzero tail
+		int maxAlign = W+2;
+		int wShift = intlog2(maxAlign);
+		addComment("Saturate the alignment, a zero Y may give a negative distance");
+		vhdl << tab << declare("shift_amt", wShift) << " <= \"" << unsignedBinary(mpz_class(maxAlign), wShift) << "\" when sf_diff > " << maxAlign << " else"
+										<< " sf_diff" << range(wShift-1, 0) << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+1));
+
+		Shifter* alignShifter = (Shifter*) newInstance("Shifter", "AlignShifter", "wIn=" + to_string(W) + " maxShift=" + to_string(maxAlign) + " dir=1", "X=>sig_Y;S=>shift_amt;R=>align_out");
+		syncCycleFromSignal("align_out");
+		setCriticalPath(alignShifter->getOutputDelay("R"));
+		int alignSize = getSignalByName("align_out")->width();
+
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(W-1));
+		addComment("Y down to three bits below the LSB of X, the bits below as a sticky bit");
+		vhdl << tab << declare("Y_top", W+3) << " <= align_out" << range(alignSize-1, alignSize-(W+3)) << ";" << endl;
+		if(alignSize > W+3)
+			vhdl << tab << declare("sticky_far") << " <= '0' when align_out" << range(alignSize-(W+4), 0) << " = 0 else '1';" << endl;
+		else
+			vhdl << tab << declare("sticky_far") << " <= '0';" << endl;
+
+		addComment("A subtracted sticky bit borrows from the bits above: the sum keeps the bits of the exact one above the sticky");
+		vhdl << tab << declare("X_far", W+5) << " <= '0' & sig_X & \"0000\";" << endl;
+		vhdl << tab << declare("Y_far", W+5) << " <= '0' & Y_top & sticky_far;" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(W+5));
+		vhdl << tab << declare("sum_far", W+5) << " <= X_far - Y_far when eff_sub = '1' else X_far + Y_far;" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("An addition may carry, a subtraction may lose one bit");
+		vhdl << tab << declare("ovf_far") << " <= sum_far" << of(W+4) << ";" << endl;
+		vhdl << tab << declare("udf_far") << " <= NOT sum_far" << of(W+4) << " AND NOT sum_far" << of(W+3) << ";" << endl;
+		vhdl << tab << declare("frac_far", W+5) << " <= sum_far when ovf_far = '1' else"
+										<< " sum_far" << range(W+2, 0) << " & \"00\" when udf_far = '1' else"
+										<< " sum_far" << range(W+3, 0) << " & '0';" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+		vhdl << tab << declare("sf_far", wSF) << " <= sf_X_ext + 1 when ovf_far = '1' else"
+										<< " sf_X_ext - 1 when udf_far = '1' else sf_X_ext;" << endl;
+		double cpFar = getCriticalPath();
+
+	//=========================================================================|
+		addFullComment("Close path: exact subtraction, normalization of the cancellation");
+	// ========================================================================|
+		setCycleFromSignal("sf_X_ext", cpSplit);
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(W+1));
+		vhdl << tab << declare("Y_close", W+1) << " <= sig_Y & '0' when sf_diff = 0 else '0' & sig_Y;" << endl;
+		vhdl << tab << declare("diff_close", W+1) << " <= (sig_X & '0') - Y_close;" << endl;
+		vhdl << tab << declare("nzero_close") << " <= '0' when diff_close = 0 else '1';" << endl;
+
+		vhdl << tab << declare("zero_var") << " <= '0';" << endl;
+		LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(W+1), "I=>diff_close;OZB=>zero_var;O=>lzc");
+		syncCycleFromSignal("lzc");
+		setCriticalPath(lzc->getOutputDelay("O"));
+
+		Shifter* normShifter = (Shifter*) newInstance("Shifter", "NormShifter", "wIn=" + to_string(W+1) + " maxShift=" + to_string(W+1) + " dir=0", "X=>diff_close;S=>lzc;R=>norm_out");
+		syncCycleFromSignal("norm_out");
+		setCriticalPath(normShifter->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+		vhdl << tab << declare("frac_close", W+5) << " <= norm_out" << range(W, 0) << " & \"0000\";" << endl;
+		vhdl << tab << declare("lzc_ext", wSF) << " <= " << zg(wSF-lzcSize) << " & lzc;" << endl;
+		vhdl << tab << declare("sf_close", wSF) << " <= sf_X_ext - lzc_ext;" << endl;
+		double cpClose = getCriticalPath();
+
+	//=========================================================================|
+		addFullComment("Path selection");
+	// ========================================================================|
+		syncCycleFromSignal("sf_far", cpFar);
+		syncCycleFromSignal("sf_close", cpClose);
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		vhdl << tab << declare("normFrac", W+5) << " <= frac_close when close = '1' else frac_far;" << endl;
+		vhdl << tab << declare("sf_sum", wSF) << " <= sf_close when close = '1' else sf_far;" << endl;
+		addComment("Zero when both operands are, or when they cancel out");
+		vhdl << tab << declare("z") << " <= (z_A AND z_B) OR (close AND NOT nzero_close);" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF) + " wF=" + to_string(W+5), "Sign=>sign;SF=>sf_sum;Frac=>normFrac;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	void PositAdd::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "InputA" );
+		mpz_class svY = tc->getInputValue ( "InputB" );
+		tc->addExpectedOutput ( "Output", model.add(svX, svY) );
+	}
+
+
+	TestCase* PositAdd::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		mpz_class a = getLargeRandom(N);
+		mpz_class b = getLargeRandom(N);
+		if(i % 2 == 1) {
+			// -a moved by a few ulps: up to a complete cancellation
+			int w = getLargeRandom(5).get_si() % (N/2+1);
+			mpz_class two_N = mpz_class(1) << N;
+			b = (two_N - a + getLargeRandom(w+1) - (mpz_class(1) << w) + two_N) % two_N;
+		}
+		tc->addInput("InputA", a);
+		tc->addInput("InputB", b);
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositAdd::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		return new PositAdd(target, N, es);
+	}
+
+
+	void PositAdd::registerFactory(){
+		UserInterface::add("PositAdd", // name
+											 "A posit adder, with a close and a far path.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult, PositFMA", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even. Subtract by adding the opposite: the 2's complement of a posit is its negation.",
+											 PositAdd::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,84 @@
+/*
+  Posit adder.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_ADD_HPP
+#define POSIT_ADD_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The sum of two N-bit posits, correctly rounded.
+	    The operands are unpacked by two PositDecoder and ordered by magnitude.
+	    Two paths then run in parallel:
+	    the far path, for an addition or scale factors at least 2 apart, aligns
+	    the smaller significand with a shifter, keeping a sticky bit, and needs
+	    at most one bit of normalization;
+	    the close path, for a subtraction with scale factors at most 1 apart,
+	    aligns by one bit at most and subtracts exactly, the cancellation being
+	    normalized by a LZOC and a left shifter.
+	    The sum of the selected path is rounded and packed by PositEncoder, as in PositMult. */
+	class PositAdd : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    */
+		PositAdd(Target* target, int N = 8, int es = 1, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositAdd() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   One test in two subtracts nearly opposite operands, for the close path */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
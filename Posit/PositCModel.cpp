@@ -0,0 +1,128 @@
+/* Generated cycle-accurate C++ models of the posit operators.
+   The generated class only needs <stdint.h>, and the GCC/Clang builtins
+   __builtin_clzll and unsigned __int128 */
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+
+#include "PositCModel.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositCModel::PositCModel() : widest(0) {
+	}
+
+
+	void PositCModel::input(string name, int width) {
+		ModelSignal s;
+		s.name = name;
+		s.width = width;
+		s.cycle = 0;
+		inputs.push_back(s);
+		widest = max(widest, width);
+	}
+
+
+	void PositCModel::signal(string name, int width, int cycle, string expr) {
+		ModelSignal s;
+		s.name = name;
+		s.width = width;
+		s.cycle = cycle;
+		s.expr = expr;
+		signals.push_back(s);
+		widest = max(widest, width);
+	}
+
+
+	void PositCModel::write(ostream& o, string className, string output, int latency) const {
+		int bits = (widest > 64 ? 128 : 64);
+		string guard = className;
+		for(char& c : guard)
+			c = toupper(c);
+
+		o << "/* Cycle-accurate C++ model of " << className << ", generated by FloPoCo." << endl;
+		o << "   Each signal is named as in the VHDL, those of the sub-components being" << endl;
+		o << "   prefixed by the name of the instance. */" << endl;
+		o << "#ifndef " << guard << "_MODEL_HPP" << endl;
+		o << "#define " << guard << "_MODEL_HPP" << endl << endl;
+		o << "#include <stdint.h>" << endl << endl;
+
+		o << "class " << className << "_model {" << endl;
+		o << "public:" << endl;
+		o << "\ttypedef " << (bits == 128 ? "unsigned __int128" : "uint64_t") << " sig_t;" << endl;
+		o << "\t/** Cycles from the inputs to the output */" << endl;
+		o << "\tstatic const int latency = " << latency << ";" << endl << endl;
+
+		o << "\t/** The signals computed from one set of inputs */" << endl;
+		o << "\tstruct Signals {" << endl;
+		for(const ModelSignal& s : inputs)
+			o << "\t\tsig_t " << s.name << ";" << endl;
+		for(const ModelSignal& s : signals)
+			o << "\t\tsig_t " << s.name << "; // width " << s.width << ", cycle " << s.cycle << endl;
+		o << "\t};" << endl << endl;
+
+		o << "\t" << className << "_model() : head(0), pipe() {}" << endl << endl;
+
+		string params, args;
+		for(size_t i = 0; i < inputs.size(); i++) {
+			params += string(i ? ", " : "") + "sig_t " + inputs[i].name;
+			args += string(i ? ", " : "") + inputs[i].name;
+		}
+
+		o << "\t/** A clock cycle: enter new inputs, and return the output of the inputs" << endl;
+		o << "\t    entered latency cycles before (0 during the first latency cycles) */" << endl;
+		o << "\tsig_t step(" << params << ") {" << endl;
+		o << "\t\thead = (head + 1) % (latency + 1);" << endl;
+		o << "\t\tcompute(pipe[head], " << args << ");" << endl;
+		o << "\t\treturn " << output << "();" << endl;
+		o << "\t}" << endl << endl;
+
+		o << "\t/** The output for these inputs, without the pipeline */" << endl;
+		o << "\tstatic sig_t eval(" << params << ") {" << endl;
+		o << "\t\tSignals s;" << endl;
+		o << "\t\tcompute(s, " << args << ");" << endl;
+		o << "\t\treturn s." << output << ";" << endl;
+		o << "\t}" << endl << endl;
+
+		o << "\t/** All the signals for these inputs */" << endl;
+		o << "\tstatic void compute(Signals& s, " << params << ") {" << endl;
+		for(const ModelSignal& s : inputs)
+			o << "\t\ts." << s.name << " = " << s.name << " & mask(" << s.width << ");" << endl;
+		for(const ModelSignal& s : signals)
+			o << "\t\ts." << s.name << " = (" << s.expr << ") & mask(" << s.width << ");" << endl;
+		o << "\t}" << endl << endl;
+
+		o << "\t/** The value of each signal at the current cycle */" << endl;
+		for(const ModelSignal& s : inputs)
+			o << "\tsig_t " << s.name << "() const {return pipe[head]." << s.name << ";}" << endl;
+		for(const ModelSignal& s : signals)
+			o << "\tsig_t " << s.name << "() const {return pipe[(head + " << latency+1-s.cycle << ") % (latency + 1)]." << s.name << ";}" << endl;
+		o << endl;
+
+		o << "private:" << endl;
+		o << "\tstatic sig_t mask(int w) {return (w >= " << bits << " ? ~(sig_t)0 : (((sig_t)1) << w) - 1);}" << endl;
+		o << "\t/** x, of w bits, sign-extended to the whole word */" << endl;
+		o << "\tstatic sig_t sext(sig_t x, int w) {return ((x >> (w-1)) & 1 ? x | ~mask(w) : x);}" << endl;
+		o << "\t/** The leading zeros of x, of w bits, w when x is zero (LZOC) */" << endl;
+		o << "\tstatic int lzc(sig_t x, int w) {" << endl;
+		o << "\t\tif(x == 0)" << endl;
+		o << "\t\t\treturn w;" << endl;
+		if(bits == 128) {
+			o << "\t\tuint64_t hi = (uint64_t)(x >> 64);" << endl;
+			o << "\t\treturn (hi ? __builtin_clzll(hi) : 64 + __builtin_clzll((uint64_t)x)) - (128 - w);" << endl;
+		}
+		else
+			o << "\t\treturn __builtin_clzll(x) - (64 - w);" << endl;
+		o << "\t}" << endl << endl;
+		o << "\t/** The entry of the inputs entered at this cycle, the others following in the ring */" << endl;
+		o << "\tint head;" << endl;
+		o << "\tSignals pipe[latency + 1];" << endl;
+		o << "};" << endl << endl;
+		o << "#endif" << endl;
+	}
+
+}//namespace
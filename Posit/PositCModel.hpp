@@ -0,0 +1,77 @@
+/*
+  Generated cycle-accurate C++ models of the posit operators.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_C_MODEL_HPP
+#define POSIT_C_MODEL_HPP
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+#include "Operator.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** Writer of a C++ class that models an operator cycle by cycle.
+	    The operators describe their signals in the order of the VHDL, each one
+	    with its width, the cycle at which the VHDL computes it, and a C++
+	    expression of the previous signals, written s.name.
+	    The class keeps the signals of the last latency+1 inputs in a ring:
+	    step() enters new inputs and returns the output of the inputs entered
+	    latency cycles before, and the accessor of a signal returns the value it
+	    has at the current cycle, that of the inputs entered cycle(signal)
+	    cycles before. All the signals must fit in 128 bits. */
+	class PositCModel {
+	public:
+		PositCModel();
+
+		/** Declare an input of the operator */
+		void input(string name, int width);
+
+		/** Declare signal name, computed at cycle from expr */
+		void signal(string name, int width, int cycle, string expr);
+
+		/** The C++ reference to a signal in the expressions */
+		static string ref(string name) {return "s." + name;}
+		/** The C++ expression of a mask of w ones */
+		static string mask(int w) {return "mask(" + to_string(w) + ")";}
+
+		/** Write the class
+		    * @param className The name of the C++ class.
+		    * @param output The signal returned by step().
+		    * @param latency The cycle of output.
+		    */
+		void write(ostream& o, string className, string output, int latency) const;
+
+		/** The widest signal */
+		int maxWidth() const {return widest;}
+
+	private:
+		struct ModelSignal {
+			string name;
+			int width;
+			int cycle;
+			string expr;
+		};
+		vector<ModelSignal> inputs;
+		vector<ModelSignal> signals;
+		int widest;
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,195 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositConstMult.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositConstMult::PositConstMult(Target* target, int N, int es, mpz_class C, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), C(C), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositConstMult";
+
+		if(C < 0 || C >= (mpz_class(1) << N))
+			THROWERROR("C must be the bit pattern of an " << N << "-bit posit, got " << C);
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositConstMult_" << N << "_" << es << "_" << C.get_str(16);
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Input", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositConstMult \n");
+		REPORT(DETAILED, "this operator has received three parameters " << N << ", " << es << " and " << C);
+
+	//=========================================================================|
+		addFullComment("Decode the constant");
+	// ========================================================================|
+		bool signC, zeroC, narC;
+		int64_t sfC;
+		mpz_class sigC;
+		int fbitsC;
+		model.decodeMpz(C, signC, zeroC, narC, sfC, sigC, fbitsC);
+
+		string nar = "'1' & " + zg(N-1);
+		if(narC) {
+			addComment("The constant is NaR");
+			vhdl << tab << "Output <= " << nar << ";" << endl;
+			return;
+		}
+		if(zeroC) {
+			addComment("The constant is zero: NaR * 0 = NaR");
+			manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(N));
+			vhdl << tab << "Output <= " << nar << " when Input = " << nar << " else " << zg(N) << ";" << endl;
+			return;
+		}
+
+		// Only the odd part of the significand is multiplied, its trailing zeros go into the scale factor
+		int tz = 0;
+		while(mpz_tstbit(sigC.get_mpz_t(), tz) == 0)
+			tz++;
+		mpz_class oddC = sigC >> tz;
+		int wC = mpz_sizeinbase(oddC.get_mpz_t(), 2);
+		REPORT(DETAILED, "Constant: sign " << signC << ", scale factor " << sfC << ", significand " << sigC << "*2^-" << fbitsC);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		PositDecoder* decoder = (PositDecoder*) newInstance("PositDecoder", "decoder", "N=" + to_string(N) + " es=" + to_string(es), "Input=>Input;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z;inf=>inf");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoder->getOutputDelay("Reg"));
+
+		addComment("Gather scale factors");
+		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+		if (es>0) vhdl << " & exp_A";
+		vhdl << ";" << endl;
+		vhdl << tab << declare("sign") << " <= " << (signC ? "NOT sign_A" : "sign_A") << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Multiply the fraction by the constant significand");
+	// ========================================================================|
+		// Canonical signed digit recoding: no two adjacent nonzero digits, at most wC/2+1 of them
+		int wP = FracSize + wC;
+		vector<string> pos, neg;
+		mpz_class c = oddC;
+		for(int i = 0; c != 0; i++) {
+			if(mpz_tstbit(c.get_mpz_t(), 0) == 1) {
+				int d = (mpz_tstbit(c.get_mpz_t(), 1) == 1 ? -1 : 1);
+				c -= d;
+				string pp = "pp_" + to_string(i);
+				vhdl << tab << declare(pp, wP) << " <= ";
+				if(wP-FracSize-i > 0)
+					vhdl << zg(wP-FracSize-i) << " & ";
+				vhdl << "frac_A" << (i > 0 ? " & " + zg(i) : "") << ";" << endl;
+				(d > 0 ? pos : neg).push_back(pp);
+			}
+			c >>= 1;
+		}
+		int nTerms = pos.size() + neg.size();
+		REPORT(DETAILED, "Shift-and-add with " << nTerms << " terms");
+		if(nTerms > 1)
+			manageCriticalPath(target->localWireDelay() + intlog2(nTerms-1) * target->adderDelay(wP));
+		vhdl << tab << declare("frac_mult", wP) << " <= " << sumTree(pos, 0, pos.size()-1);
+		if(!neg.empty())
+			vhdl << " - " << sumTree(neg, 0, neg.size()-1);
+		vhdl << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("Adjust for overflow");
+		vhdl << tab << declare("ovf_m") << " <= frac_mult(frac_mult'high);" << endl;
+		vhdl << tab << declare("normFrac", wP) << " <= frac_mult" << range(wP-2, 0) << " & '0' when ovf_m = '0' else"
+												<< " frac_mult;" << endl;
+		addComment("Add the scale factor of the constant");
+		// oddC*2^tz has its hidden bit at fbitsC, so the product is normalized like in PositMult
+		int wSF = RegSize+es+1;
+		mpz_class sfK = mpz_class((long)sfC);
+		if(sfK < 0)
+			sfK += mpz_class(1) << wSF;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+		vhdl << tab << declare("sf_mult", wSF) << " <= (sf_A(sf_A'high) & sf_A) + \"" << unsignedBinary(sfK, wSF) << "\" + ovf_m;" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF) + " wF=" + to_string(wP), "Sign=>sign;SF=>sf_mult;Frac=>normFrac;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	string PositConstMult::sumTree(vector<string> terms, int first, int last) {
+		if(first == last)
+			return terms[first];
+		int mid = (first + last) / 2;
+		return "(" + sumTree(terms, first, mid) + " + " + sumTree(terms, mid+1, last) + ")";
+	}
+
+
+	void PositConstMult::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "Input" );
+		tc->addExpectedOutput ( "Output", model.mult(svX, C) );
+	}
+
+
+	OperatorPtr PositConstMult::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		string C;
+		UserInterface::parseString(args, "C", &C);
+		mpz_class c;
+		if(c.set_str(C, 0) != 0)
+			throw string("PositConstMult: C must be an integer, decimal or 0x hexadecimal, got ") + C;
+		return new PositConstMult(target, N, es, c);
+	}
+
+
+	void PositConstMult::registerFactory(){
+		UserInterface::add("PositConstMult", // name
+											 "A posit multiplier by a constant posit.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size; \
+                        					 C(string): The bit pattern of the constant, in decimal or 0x hexadecimal",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even, as PositMult does. e.g. C=0x48 is 1.5 for N=8 es=1.",
+											 PositConstMult::parseArguments
+											 ) ;
+	}
+
+}//namespace
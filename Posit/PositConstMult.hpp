@@ -0,0 +1,81 @@
+/*
+  Posit multiplier by a constant.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_CONST_MULT_HPP
+#define POSIT_CONST_MULT_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The correctly rounded product of an N-bit posit by a constant posit.
+	    The constant is decoded at generation time: its sign and scale factor
+	    are constants of the datapath, and its significand is multiplied by
+	    a shift-and-add tree over its canonical signed digit recoding.
+	    A zero or NaR constant gives an operator without datapath. */
+	class PositConstMult : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** The bit pattern of the constant */
+		mpz_class C;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** Balanced sum of the signals in terms, as a VHDL expression */
+		string sumTree(vector<string> terms, int first, int last);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param C The bit pattern of the constant posit.
+		    */
+		PositConstMult(Target* target, int N = 8, int es = 1, mpz_class C = mpz_class(0), map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositConstMult() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,230 @@
+/* Coverage-directed test vectors for the posit operators.
+   The bins are computed on the software model, from the same decoded values
+   and rounding as emulate */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include "PositCoverage.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositCoverage::PositCoverage(vector<Bin> bins) : bins(bins), total(0) {
+		for(int b = 0; b < NumBins; b++)
+			counts[b] = 0;
+	}
+
+
+	void PositCoverage::add(uint32_t hits) {
+		total++;
+		for(int b = 0; b < NumBins; b++)
+			if(hits & (1 << b))
+				counts[b]++;
+	}
+
+
+	bool PositCoverage::complete() const {
+		for(Bin b : bins)
+			if(counts[b] == 0)
+				return false;
+		return true;
+	}
+
+
+	string PositCoverage::summary() const {
+		ostringstream o;
+		string missed;
+		for(size_t j = 0; j < bins.size(); j++) {
+			o << (j ? ", " : "") << binName(bins[j]) << " " << counts[bins[j]];
+			if(counts[bins[j]] == 0)
+				missed += (missed.empty() ? "" : ", ") + string(binName(bins[j]));
+		}
+		o << ". Not reached: " << (missed.empty() ? "none" : missed);
+		return o.str();
+	}
+
+
+	const char* PositCoverage::binName(Bin b) {
+		static const char* names[NumBins] = {"zero", "NaR", "negative", "longest regime", "regime carry",
+											 "exponent truncated", "no fraction", "ovf_reg", "ovf_regF",
+											 "maxpos saturation", "minpos saturation", "exact", "round down",
+											 "round up", "tie down", "tie up"};
+		return names[b];
+	}
+
+
+	vector<PositCoverage::Bin> PositCoverage::decoderBins(int es) {
+		vector<Bin> b = {Zero, NaR, Negative, LongestRegime, RegimeCarry, NoFraction};
+		if(es > 0)
+			b.push_back(ExpTruncated);
+		return b;
+	}
+
+
+	vector<PositCoverage::Bin> PositCoverage::multBins(int es) {
+		vector<Bin> b = {Zero, NaR, Negative, OvfReg, OvfRegF, MaxposSaturation, MinposSaturation,
+						 Exact, RoundDown, RoundUp, TieDown, TieUp};
+		if(es > 0)
+			b.push_back(ExpTruncated);
+		return b;
+	}
+
+
+	uint32_t PositCoverage::mask(vector<Bin> bins) {
+		uint32_t m = 0;
+		for(Bin b : bins)
+			m |= 1 << b;
+		return m;
+	}
+
+
+	uint32_t PositCoverage::decoderHits(const PositModel& m, uint64_t x) {
+		PositValue v;
+		m.decode(x, v);
+		if(v.zero)
+			return 1 << Zero;
+		if(v.nar)
+			return 1 << NaR;
+		int N = m.N;
+		int es = m.es;
+		uint32_t h = (v.sign ? 1 << Negative : 0);
+		int64_t k = v.sf >> es;
+		int64_t e = v.sf - k * (((int64_t)1) << es);
+		// the regime with its terminating bit, cut at N-1 bits
+		int64_t regBits = (k >= 0 ? k+2 : -k+1);
+		if(regBits > N-1)
+			regBits = N-1;
+		if(k == N-2 || k == -(N-2))
+			h |= 1 << LongestRegime;
+		if(v.sign && e == 0 && v.sig == (((uint64_t)1) << 63))
+			h |= 1 << RegimeCarry;
+		if(es > 0 && regBits+es > N-1)
+			h |= 1 << ExpTruncated;
+		if(regBits+es >= N-1)
+			h |= 1 << NoFraction;
+		return h;
+	}
+
+
+	uint32_t PositCoverage::multHits(const PositModel& m, uint64_t a, uint64_t b, uint64_t* r) {
+		PositValue va, vb, vr;
+		m.decode(a, va);
+		m.decode(b, vb);
+		m.multExact(va, vb, vr);
+		PositRounding rd;
+		uint64_t p = m.encode(vr, &rd);
+		if(r)
+			*r = p;
+		if(vr.nar)
+			return 1 << NaR;
+		if(vr.zero)
+			return 1 << Zero;
+		int N = m.N;
+		uint32_t h = (vr.sign ? 1 << Negative : 0);
+		// the regime absolute value of PositEncoder
+		int64_t k = vr.sf >> m.es;
+		int64_t reg = (k >= 0 ? k : -k);
+		if(reg > N-1)
+			h |= 1 << OvfReg;
+		else if(reg == N-1)
+			h |= 1 << OvfRegF;
+		if(rd.saturated)
+			h |= 1 << (k > 0 ? MaxposSaturation : MinposSaturation);
+		else {
+			if(rd.expTruncated)
+				h |= 1 << ExpTruncated;
+			if(!rd.guard)
+				h |= 1 << (rd.sticky ? RoundDown : Exact);
+			else if(rd.sticky)
+				h |= 1 << RoundUp;
+			else
+				h |= 1 << (rd.lsb ? TieUp : TieDown);
+		}
+		return h;
+	}
+
+
+	uint64_t PositCoverage::regimePosit(uint64_t i, int stream, int N, int minRun, int ones, int zeros) {
+		uint64_t r = bits(i, 8+2*stream, 64);
+		int run = minRun + (int)((r & 0xffff) % (N-minRun));
+		bool one = (ones < 0 ? (r >> 16) & 1 : ones == 1);
+		bool neg = (r >> 17) & 1;
+		// the bits after the terminating bit, none for a run of N-1
+		int rest = N-2-run;
+		uint64_t runBits = (one ? (((uint64_t)1) << run) - 1 : 0);
+		uint64_t p;
+		if(rest < 0)
+			p = runBits;
+		else {
+			uint64_t tail = bits(i, 9+2*stream, rest);
+			if(zeros < 0 && ((r >> 18) & 3) == 0)
+				tail = 0;
+			else if(zeros > 0)
+				tail &= ~((((uint64_t)1) << min(zeros, rest)) - 1);
+			p = (((runBits << 1) | (one ? 0 : 1)) << rest) | tail;
+		}
+		// a run of N-1 zeros is not a regime
+		if(p == 0)
+			p = 1;
+		uint64_t mask = (N == 64 ? ~((uint64_t)0) : (((uint64_t)1) << N) - 1);
+		return (neg ? -p : p) & mask;
+	}
+
+
+	uint64_t PositCoverage::specialPosit(uint64_t i, int stream, int N) {
+		uint64_t mask = (N == 64 ? ~((uint64_t)0) : (((uint64_t)1) << N) - 1);
+		uint64_t special[4] = {0, ((uint64_t)1) << (N-2), 1, mask >> 1};
+		uint64_t r = bits(i, 8+2*stream, 3);
+		if(r == 4)
+			return ((uint64_t)1) << (N-1);
+		return ((r & 4) ? -special[r & 3] : special[r & 3]) & mask;
+	}
+
+
+	uint64_t PositCoverage::decoderInput(uint64_t i, int N) {
+		int sel = bits(i, 0, 4);
+		if(sel < 8)
+			return bits(i, 1, N);
+		if(sel < 13)
+			return regimePosit(i, 1, N, 1);
+		if(sel < 15)
+			// maxpos, minpos and their neighbours
+			return regimePosit(i, 1, N, N-2);
+		return specialPosit(i, 1, N);
+	}
+
+
+	void PositCoverage::multInputs(uint64_t i, int N, uint64_t& a, uint64_t& b) {
+		int sel = bits(i, 0, 4);
+		if(sel < 7) {
+			a = bits(i, 1, N);
+			b = bits(i, 2, N);
+		}
+		else if(sel < 9) {
+			a = regimePosit(i, 1, N, 1);
+			b = regimePosit(i, 2, N, 1);
+		}
+		else if(sel < 11) {
+			// long regimes of the same direction: the product saturates, or nearly
+			int ones = bits(i, 3, 1);
+			a = regimePosit(i, 1, N, N/2, ones);
+			b = regimePosit(i, 2, N, N/2, ones);
+		}
+		else if(sel < 14) {
+			// a fraction ending with a random number of zeros, times a power of useed:
+			// the regime of the product is longer or shorter, and the cut often falls on a tie
+			a = regimePosit(i, 1, N, 1, -1, bits(i, 3, 8) % (N-1));
+			b = regimePosit(i, 2, N, 1, -1, N);
+		}
+		else {
+			// zero, NaR, 1, minpos or maxpos, times any posit
+			a = specialPosit(i, 1, N);
+			b = regimePosit(i, 2, N, 1);
+			if(sel == 15)
+				swap(a, b);
+		}
+	}
+
+}//namespace
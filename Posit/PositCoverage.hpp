@@ -0,0 +1,118 @@
+/*
+  Coverage-directed test vectors for the posit operators.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_COVERAGE_HPP
+#define POSIT_COVERAGE_HPP
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "PositModel.hpp"
+#include "PositTestVectors.hpp"
+
+
+namespace flopoco {
+
+	/** Coverage of the special paths of the posit operators by a test campaign,
+	    and biased generators reaching them.
+	    Uniform input bits give regimes of one or two bits most of the time: long
+	    regimes, saturation to maxpos or minpos, exponents cut by the regime and
+	    rounding ties are then hit once in thousands of tests, or never for
+	    posit32. The generators draw the regime length uniformly instead, and
+	    build products that saturate or round to a tie, and mix in the special
+	    values, with nearly half of the tests staying uniform. Like PositTestVectors::randomBits, test i only depends
+	    on i. */
+	class PositCoverage {
+	public:
+		/** The paths reached by a test */
+		enum Bin {
+			Zero,
+			NaR,
+			Negative,
+			/** A regime of N-1 bits: maxpos, minpos and their opposites */
+			LongestRegime,
+			/** A negative input whose exponent and fraction are zeros:
+			    its 2's complement carries into the regime */
+			RegimeCarry,
+			/** Some exponent bits cut by the regime */
+			ExpTruncated,
+			/** No fraction bit left by the regime and exponent */
+			NoFraction,
+			/** The encoder regime beyond N-1 (ovf_reg) */
+			OvfReg,
+			/** The encoder regime at N-1 (ovf_regF without ovf_reg) */
+			OvfRegF,
+			MaxposSaturation,
+			MinposSaturation,
+			Exact,
+			RoundDown,
+			RoundUp,
+			/** Round to nearest even, halfway between two posits */
+			TieDown,
+			TieUp,
+			NumBins
+		};
+
+		/** Count the tests reaching each of bins */
+		PositCoverage(std::vector<Bin> bins);
+
+		/** Count a test reaching the bins of mask hits */
+		void add(uint32_t hits);
+		uint64_t tests() const {return total;}
+		uint64_t count(Bin b) const {return counts[b];}
+		/** true when every bin was reached */
+		bool complete() const;
+		/** Tests per bin, then the bins not reached */
+		std::string summary() const;
+		/** true after test n when the summary is due: at powers of two and at each batch */
+		static bool reportDue(uint64_t n) {return n >= 1024 && ((n & (n-1)) == 0 || n % positTestBatchSize == 0);}
+
+		static const char* binName(Bin b);
+		/** The bins of PositDecoder and PositMult */
+		static std::vector<Bin> decoderBins(int es);
+		static std::vector<Bin> multBins(int es);
+		/** The mask of hits of bins */
+		static uint32_t mask(std::vector<Bin> bins);
+
+		/** The bins an input of PositDecoder reaches */
+		static uint32_t decoderHits(const PositModel& m, uint64_t x);
+		/** The bins a product reaches, r being set to the rounded product when not NULL */
+		static uint32_t multHits(const PositModel& m, uint64_t a, uint64_t b, uint64_t* r = NULL);
+
+		/** Biased input of PositDecoder for test i */
+		static uint64_t decoderInput(uint64_t i, int N);
+		/** Biased operands of PositMult for test i */
+		static void multInputs(uint64_t i, int N, uint64_t& a, uint64_t& b);
+
+		/** A random N-bit posit with a regime run of minRun to N-1 bits
+		    * @param stream Selects an independent sequence, 1 or 2.
+		    * @param ones 1 for a run of ones (scale >= 1), 0 for zeros, -1 for either.
+		    * @param zeros The number of low bits of the exponent and fraction forced to zero, -1 for all of them once in four.
+		    */
+		static uint64_t regimePosit(uint64_t i, int stream, int N, int minRun, int ones = -1, int zeros = -1);
+
+		/** One of zero, NaR, 1, minpos, maxpos and their opposites */
+		static uint64_t specialPosit(uint64_t i, int stream, int N);
+
+	private:
+		std::vector<Bin> bins;
+		uint64_t counts[NumBins];
+		uint64_t total;
+
+		/** Random bits of test i, independent for each stream */
+		static uint64_t bits(uint64_t i, int stream, int w) {return PositTestVectors::randomBits(i*16 + stream, 0, w);}
+	};
+
+}//namespace
+
+
+#endif
@@ -9,6 +9,7 @@
 #include <gmp.h>
 #include <mpfr.h>
 #include <stdio.h>
+#include <algorithm>
 
 #include "utils.hpp"
 #include "Operator.hpp"
@@ -24,8 +25,8 @@ namespace flopoco {
 	//extern vector<Operator *> oplist;
 
 
-	PositDecoder::PositDecoder(Target* target, int N, int es, map<string, double> inputDelays) :
-	Operator(target), N(N), es(es) {
+	PositDecoder::PositDecoder(Target* target, int N, int es, int threads, int arch, bool varEs, bool report, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), model(N, es), threads(threads), arch(arch), varEs(varEs), pool(NULL), batchFirst(0), coverage(PositCoverage::decoderBins(es)) {
 		/* constructor of the PositDecoder
 		   Target is the targeted FPGA : Stratix, Virtex ... (see Target.hpp for more informations)
 		   param0 and param1 are some parameters declared by this Operator developpers, 
@@ -41,18 +42,34 @@ namespace flopoco {
 		// definition of the name of the operator
 		ostringstream name;
 		name << "PositDecoder_" << N << "_" << es;
+		if(arch == 1)
+			name << "_raw";
+		if(varEs)
+			name << "_vares";
 		setNameWithFreqAndUID(name.str());
 		// Copyright 
 		setCopyrightString("Raul Murillo, 2019");
 
+		if(arch < 0 || arch > 1)
+			THROWERROR("arch must be 0 or 1");
+		if(varEs && (es < 1 || es > N-4))
+			THROWERROR("varEs needs 1 <= es <= N-4, got es=" << es);
+		if(varEs)
+			for(int e = 0; e <= es; e++)
+				models.push_back(PositModel(N, e));
+
 		// the addition operators need the ieee_std_signed/unsigned libraries
 		//useNumericStd();
 
-		sizeRegime = intlog2(N);
-		sizeFraction = N-es-2;
+		// wide enough for a regime of -(N-1) to N-2, whatever N
+		sizeRegime = intlog2(N-1)+1;
+		// with varEs, the fraction is as wide as for es=0, and Exp is right-aligned
+		sizeFraction = (varEs ? N-2 : N-es-2);
 
 		/* SET UP THE IO SIGNALS */
 		addInput  ( "Input"	, N);
+		if(varEs)
+			addInput  ( "ES"	, intlog2(es));
 		addOutput ( "Sign"	);
 		addOutput ( "Reg"	, sizeRegime);
 		if(es>0){
@@ -92,13 +109,15 @@ namespace flopoco {
 		addFullComment("Special Cases");
 	// ========================================================================|
 		
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		// Registers are placed from the target frequency: each manageCriticalPath gets the delay of the statements that follow it
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(N-1));
 		vhdl << tab << declare("nzero") << " <= '0' when Input" << range(N-2, 0) <<" = 0 else '1';" << endl;
 		manageCriticalPath(target->localWireDelay() + target->lutDelay());
 		addComment("1 if Input is zero");
 		vhdl << tab << "z <= Input" << of(N-1) << " NOR nzero;" << endl;		 // 1 if Input is zero
 		addComment("1 if Input is infinity");
 		vhdl << tab << "inf <= Input" << of(N-1) << " AND (NOT nzero);" << endl; // 1 if Input is infinity
+		costs.stage(this, "special cases", PositReport::comparatorLuts(target, N-1) + 2, {"Input", "z", "inf"});
 		
 	//=========================================================================|
 		addFullComment("Extract Sign bit");
@@ -106,75 +125,326 @@ namespace flopoco {
 		vhdl << tab << declare("my_sign") << " <= Input" << of(N-1) << ";" << endl;
 		vhdl << tab << "Sign <= my_sign;" << endl;
 
-	//=========================================================================|
-		addFullComment("2's Complement of Input");
-	// ========================================================================|
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-		vhdl << tab << declare("rep_sign", N-1) << " <= (others => my_sign);" << endl;
-		vhdl << tab << declare("twos", N-1) << " <= (rep_sign XOR Input" << range(N-2,0) << ") + my_sign;" << endl;
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-		vhdl << tab << declare("rc") << " <= twos" << of(N-2) << ";" << endl;	// Regime check
-
-	//=========================================================================|
-		addFullComment("Count leading zeros of regime");
-	// ========================================================================|
-		// count the sequence of 0 bits terminating in a 1 bit - regime
-		// zc ← Leading Zero Detector (inv)
-		// we use the FloPoCo pipelined operator LZOC
-
-		vhdl << tab << declare("rep_rc", N-1) << " <= (others => rc);" << endl;
-		addComment("Invert 2's");
-		vhdl << tab << declare("inv", N-1) << " <= rep_rc XOR twos;" << endl;
+		if(arch == 0) {
+		//=========================================================================|
+			addFullComment("2's Complement of Input");
+		// ========================================================================|
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(N-1));
+			vhdl << tab << declare("rep_sign", N-1) << " <= (others => my_sign);" << endl;
+			vhdl << tab << declare("twos", N-1) << " <= (rep_sign XOR Input" << range(N-2,0) << ") + my_sign;" << endl;
+			vhdl << tab << declare("rc") << " <= twos" << of(N-2) << ";" << endl;	// Regime check
+			costs.stage(this, "2's complement", N-1, {"twos", "rc", "z", "inf"});
+
+		//=========================================================================|
+			addFullComment("Count leading zeros of regime");
+		// ========================================================================|
+			// count the sequence of 0 bits terminating in a 1 bit - regime
+			// zc ← Leading Zero Detector (inv)
+			// we use the FloPoCo pipelined operator LZOC
+
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << declare("rep_rc", N-1) << " <= (others => rc);" << endl;
+			addComment("Invert 2's");
+			vhdl << tab << declare("inv", N-1) << " <= rep_rc XOR twos;" << endl;
 	
-		vhdl << tab << declare("zero_var") << " <= '0';" << endl;
-		LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(N-1), "I=>inv;OZB=>zero_var;O=>zc");
-		syncCycleFromSignal("zc");
-		setCriticalPath(lzc->getOutputDelay("O"));
-
-	//=========================================================================|
-		addFullComment("Shift out the regime");
-	// ========================================================================|
-		int zc_size = getSignalByName("zc")->width();
-		vhdl << tab << declare("zc_sub", zc_size) << " <= zc - 1;" << endl;
-		Shifter* leftShifter = (Shifter*) newInstance("Shifter", "LeftShifterComponent", "wIn=" + to_string(N-1) + " maxShift=" + to_string(N-1) + " dir=0", "X=>twos;S=>zc_sub;R=>shifted_twos");
-		syncCycleFromSignal("shifted_twos");
-		setCriticalPath(leftShifter->getOutputDelay("R"));
-
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-		vhdl << tab << declare("tmp", N-3) << " <= shifted_twos" << range(N-4, 0) << ";"<<endl;
+			vhdl << tab << declare("zero_var") << " <= '0';" << endl;
+			costs.stage(this, "regime inversion", N-1, {"inv", "twos", "rc", "z", "inf"});
+			LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(N-1), "I=>inv;OZB=>zero_var;O=>zc");
+			syncCycleFromSignal("zc");
+			setCriticalPath(lzc->getOutputDelay("O"));
+			costs.component(this, "regime count", lzc, PositReport::lzocLuts(N-1), 0, {"zc", "twos", "rc", "z", "inf"});
+
+		//=========================================================================|
+			addFullComment("Shift out the regime");
+		// ========================================================================|
+			int zc_size = getSignalByName("zc")->width();
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(zc_size));
+			vhdl << tab << declare("zc_sub", zc_size) << " <= zc - 1;" << endl;
+			costs.stage(this, "regime shift amount", zc_size, {"zc_sub", "zc", "twos", "rc", "z", "inf"});
+			Shifter* leftShifter = (Shifter*) newInstance("Shifter", "LeftShifterComponent", "wIn=" + to_string(N-1) + " maxShift=" + to_string(N-1) + " dir=0", "X=>twos;S=>zc_sub;R=>shifted_twos");
+			syncCycleFromSignal("shifted_twos");
+			setCriticalPath(leftShifter->getOutputDelay("R"));
+			vhdl << tab << declare("tmp", N-3) << " <= shifted_twos" << range(N-4, 0) << ";"<<endl;
+			costs.component(this, "regime shift", leftShifter, PositReport::shifterLuts(target, N-1, N-1), 0, {"tmp", "zc", "zc_sub", "rc", "z", "inf"});
+		}
+		else {
+		//=========================================================================|
+			addFullComment("Count the regime on the raw bits");
+		// ========================================================================|
+			// The run of bits equal to Input(N-2) is that of the one's complement of Input:
+			// it is counted without waiting for the 2's complement
+			vhdl << tab << declare("rb") << " <= Input" << of(N-2) << ";" << endl;
+			vhdl << tab << declare("rc") << " <= rb XOR my_sign;" << endl;	// Regime check
+			vhdl << tab << declare("raw", N-1) << " <= Input" << range(N-2,0) << ";" << endl;
+			double cpIn = getCriticalPath();
+			LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(N-1), "I=>raw;OZB=>rb;O=>zc");
+			syncCycleFromSignal("zc");
+			setCriticalPath(lzc->getOutputDelay("O"));
+			double cpZc = getCriticalPath();
+
+			int zc_size = getSignalByName("zc")->width();
+			costs.component(this, "regime count", lzc, PositReport::lzocLuts(N-1), 0, {"zc", "rc", "z", "inf"});
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(zc_size+1));
+			vhdl << tab << declare("zc_sub", zc_size) << " <= zc - 1;" << endl;
+			vhdl << tab << declare("zc_sub2", zc_size+1) << " <= ('0' & zc) - 2;" << endl;
+			costs.stage(this, "regime fix-up operands", 2*zc_size+1, {"zc", "zc_sub", "zc_sub2", "rc", "z", "inf"});
+
+		//=========================================================================|
+			addFullComment("2's Complement of Input, in parallel with the count");
+		// ========================================================================|
+			setCycleFromSignal("raw", cpIn);
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(N-1));
+			vhdl << tab << declare("rep_sign", N-1) << " <= (others => my_sign);" << endl;
+			vhdl << tab << declare("twos", N-1) << " <= (rep_sign XOR raw) + my_sign;" << endl;
+			costs.stage(this, "2's complement", N-1, {"twos", "rc", "z", "inf"});
+			syncCycleFromSignal("zc", cpZc);
+
+		//=========================================================================|
+			addFullComment("Shift out the regime");
+		// ========================================================================|
+			// Shifting by zc leaves the last regime bit and the terminating bit on top of the fields
+			Shifter* leftShifter = (Shifter*) newInstance("Shifter", "LeftShifterComponent", "wIn=" + to_string(N-1) + " maxShift=" + to_string(N-1) + " dir=0", "X=>twos;S=>zc;R=>shifted_twos");
+			syncCycleFromSignal("shifted_twos");
+			setCriticalPath(leftShifter->getOutputDelay("R"));
+			vhdl << tab << declare("tmp", N-3) << " <= shifted_twos" << range(N-3, 1) << ";"<<endl;
+			costs.component(this, "regime shift", leftShifter, PositReport::shifterLuts(target, N-1, N-1), 0, {"tmp", "zc", "zc_sub", "zc_sub2", "rc", "nzero", "my_sign", "z", "inf"});
+
+		//=========================================================================|
+			addFullComment("Fix up the regime");
+		// ========================================================================|
+			// When the increment of the 2's complement carries into the regime, the fields are all zeros
+			// and the regime is one more than counted: the top bits are then not the expected rc, NOT rc
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << declare("reg_carry") << " <= my_sign AND nzero AND "
+					<< "((shifted_twos" << of(N-1) << " XOR rc) OR NOT(shifted_twos" << of(N-2) << " XOR rc));" << endl;
+			// zero and NaR read as a run of N-1 zeros, as with the 2's complement
+			vhdl << tab << declare("reg_pos") << " <= rc AND nzero;" << endl;
+			costs.stage(this, "regime fix-up", 2, {"tmp", "zc", "zc_sub", "zc_sub2", "reg_carry", "reg_pos", "z", "inf"});
+		}
 
 	//=========================================================================|
 		addFullComment("Extract fraction and exponent");
 	// ========================================================================|
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-		vhdl << tab << "Frac <= nzero & tmp" << range(N-es-4,0) << ";" << endl;
-		if(es>0){
-			vhdl << tab << "Exp <= tmp" << range(N-4,N-es-3) << ";" << endl;
+		if(varEs) {
+			// The exponent field is the top ES bits of tmp, the fraction is shifted up by ES.
+			// ES > es, which the port width allows when es+1 is not a power of 2, is taken as es
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << declare("frac_sh", N-3) << " <= ";
+			for(int e = es; e > 0; e--)
+				vhdl << "tmp" << range(N-4-e, 0) << " & " << zg(e) << " when ES " << (e == es ? ">= " : "= ") << e << " else ";
+			vhdl << "tmp;" << endl;
+			vhdl << tab << "Frac <= nzero & frac_sh;" << endl;
+			vhdl << tab << "Exp <= ";
+			for(int e = es; e > 0; e--)
+				vhdl << (e < es ? zg(es-e) + " & " : "") << "tmp" << range(N-4, N-3-e) << " when ES " << (e == es ? ">= " : "= ") << e << " else ";
+			vhdl << zg(es) << ";" << endl;
+			vector<string> inFlight = {"Frac", "Exp", "zc", "zc_sub", "z", "inf"};
+			if(arch == 0)
+				inFlight.push_back("rc");
+			else
+				inFlight.insert(inFlight.end(), {"zc_sub2", "reg_carry", "reg_pos"});
+			costs.stage(this, "exponent size multiplexers", N-3+es, inFlight);
 		}
-		else{
-			vhdl << tab << "Exp <= \"0\";" << endl;
+		else {
+			vhdl << tab << "Frac <= nzero & tmp" << range(N-es-4,0) << ";" << endl;
+			if(es>0){
+				vhdl << tab << "Exp <= tmp" << range(N-4,N-es-3) << ";" << endl;
+			}
+			else{
+				vhdl << tab << "Exp <= \"0\";" << endl;
+			}
 		}
 		 
 
 	//=========================================================================|
 		addFullComment("Select regime");
 	// ========================================================================|
-		vhdl << tab << "Reg <= '0' & zc_sub when rc = '1' else "
-					<< "NOT('0' & zc) + 1;" << endl; //-zc
+		if(arch == 0) {
+			int zc_size = getSignalByName("zc")->width();
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(zc_size+1));
+			vhdl << tab << "Reg <= '0' & zc_sub when rc = '1' else "
+						<< "NOT('0' & zc) + 1;" << endl; //-zc
+			costs.stage(this, "regime", zc_size+1, {"Sign", "Reg", "Exp", "Frac", "z", "inf"});
+		}
+		else {
+			// -zc is NOT(zc-1), and -zc+1 is NOT(zc-2)
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << "Reg <= '0' & zc when (reg_pos AND reg_carry) = '1' else "
+						<< "'0' & zc_sub when reg_pos = '1' else "
+						<< "NOT zc_sub2 when reg_carry = '1' else "
+						<< "NOT('0' & zc_sub);" << endl;
+			costs.stage(this, "regime", sizeRegime, {"Sign", "Reg", "Exp", "Frac", "z", "inf"});
+		}
 
 		//update output slack
 		outDelayMap["Reg"] = getCriticalPath();
 
+		if(report) {
+			REPORT(INFO, "Writing the estimated delays and resources to " << getName() << ".json");
+			costs.write(this);
+		}
+
 	};
 
-	
-/*	void PositDecoder::emulate(TestCase * tc) {
+
+	PositDecoder::~PositDecoder() {
+		for(TestCase* tc : batchTests)
+			delete tc;
+		delete pool;
+	}
+
+
+	void PositDecoder::decodeOutputs(uint64_t x, uint64_t* out, int esIn) const {
+		const PositModel& m = (varEs ? models[esIn] : model);
+		int es = (varEs ? esIn : this->es);
+		PositValue v;
+		m.decode(x, v);
+		int64_t k, e;
+		uint64_t frac;
+		if(v.zero || v.nar) {
+			// the 2's complement is then 0, whose regime is a run of N-1 zeros
+			k = -(N-1);
+			e = 0;
+			frac = 0;
+		}
+		else {
+			k = v.sf >> es;
+			e = v.sf - k * (((int64_t)1) << es);
+			int wF = sizeFraction-1;
+			frac = (wF > 0 ? (v.sig << 1) >> (64-wF) : 0) | (((uint64_t)1) << wF);
+		}
+		out[0] = v.sign;
+		out[1] = (uint64_t)k & ((((uint64_t)1) << sizeRegime) - 1);
+		out[2] = (uint64_t)e;
+		out[3] = frac;
+		out[4] = v.zero;
+		out[5] = v.nar;
 	}
-*/
 
-//	void PositDecoder::buildStandardTestCases(TestCaseList * tcl) {
-		// please fill me with regression tests or corner case tests!
-//	}
+
+	void PositDecoder::cModel(PositCModel& m, string prefix, string input, int cycle) {
+		if(arch != 0 || varEs)
+			THROWERROR("the C++ model is only available for arch=0 and a fixed es");
+		// the C++ reference to a signal, and the cycle of a signal in the model
+		auto s = [prefix](string name) {return PositCModel::ref(prefix + name);};
+		auto c = [this, cycle](string name) {return cycle + getSignalByName(name)->getCycle();};
+		int zc_size = getSignalByName("zc")->width();
+
+		m.signal(prefix + "Input", N, cycle, input);
+		m.signal(prefix + "nzero", 1, c("nzero"), "(" + s("Input") + " & " + PositCModel::mask(N-1) + ") != 0");
+		m.signal(prefix + "my_sign", 1, c("my_sign"), s("Input") + " >> " + to_string(N-1));
+		m.signal(prefix + "z", 1, c("z"), "!(" + s("my_sign") + " | " + s("nzero") + ")");
+		m.signal(prefix + "inf", 1, c("inf"), s("my_sign") + " & !" + s("nzero"));
+		m.signal(prefix + "Sign", 1, c("Sign"), s("my_sign"));
+		m.signal(prefix + "twos", N-1, c("twos"), "((" + s("my_sign") + " ? " + PositCModel::mask(N-1) + " : 0) ^ " + s("Input") + ") + " + s("my_sign"));
+		m.signal(prefix + "rc", 1, c("rc"), s("twos") + " >> " + to_string(N-2));
+		m.signal(prefix + "inv", N-1, c("inv"), "(" + s("rc") + " ? " + PositCModel::mask(N-1) + " : 0) ^ " + s("twos"));
+		m.signal(prefix + "zc", zc_size, c("zc"), "lzc(" + s("inv") + ", " + to_string(N-1) + ")");
+		m.signal(prefix + "zc_sub", zc_size, c("zc_sub"), s("zc") + " - 1");
+		m.signal(prefix + "shifted_twos", 2*N-2, c("shifted_twos"), s("twos") + " << " + s("zc_sub"));
+		m.signal(prefix + "tmp", N-3, c("tmp"), s("shifted_twos"));
+		m.signal(prefix + "Frac", sizeFraction, c("Frac"), "(" + s("nzero") + " << " + to_string(N-es-3) + ") | (" + s("tmp") + " & " + PositCModel::mask(N-es-3) + ")");
+		m.signal(prefix + "Exp", max(es, 1), c("Exp"), (es > 0 ? s("tmp") + " >> " + to_string(N-es-3) : string("0")));
+		m.signal(prefix + "Reg", sizeRegime, c("Reg"), s("rc") + " ? " + s("zc_sub") + " : ~" + s("zc") + " + 1");
+	}
+
+
+	void PositDecoder::emulate(TestCase * tc) {
+		if(N > 64)
+			THROWERROR("emulate is only available for N <= 64");
+		mpz_class svX = tc->getInputValue("Input");
+		uint64_t out[6];
+		decodeOutputs(mpz_get_ui(svX.get_mpz_t()), out, (varEs ? min((int)tc->getInputValue("ES").get_si(), es) : 0));
+		tc->addExpectedOutput("Sign", mpz_class((unsigned long) out[0]));
+		tc->addExpectedOutput("Reg", mpz_class((unsigned long) out[1]));
+		tc->addExpectedOutput("Exp", mpz_class((unsigned long) out[2]));
+		tc->addExpectedOutput("Frac", mpz_class((unsigned long) out[3]));
+		tc->addExpectedOutput("z", mpz_class((unsigned long) out[4]));
+		tc->addExpectedOutput("inf", mpz_class((unsigned long) out[5]));
+	}
+
+
+	TestCase* PositDecoder::buildRandomTestCase(int i) {
+		if(N > 64)
+			THROWERROR("emulate is only available for N <= 64");
+		if(varEs) {
+			TestCase *tc = new TestCase(this);
+			tc->addInput("Input", getLargeRandom(N));
+			tc->addInput("ES", PositTestVectors::randomEs(es));
+			emulate(tc);
+			return tc;
+		}
+		uint64_t idx = (unsigned)i;
+		if(batchTests.empty() || idx < batchFirst || idx >= batchFirst + batchTests.size() || batchTests[idx-batchFirst] == NULL)
+			fillBatch(idx - idx % positTestBatchSize);
+		uint64_t k = idx - batchFirst;
+		coverage.add(batchHits[k]);
+		if(PositCoverage::reportDue(coverage.tests()))
+			REPORT(INFO, "Coverage after " << coverage.tests() << " tests: " << coverage.summary());
+		TestCase* tc = batchTests[k];
+		batchTests[k] = NULL;
+		return tc;
+	}
+
+
+	void PositDecoder::fillBatch(uint64_t first) {
+		for(TestCase* tc : batchTests)
+			delete tc;
+		batchFirst = first;
+		batchTests.assign(positTestBatchSize, NULL);
+		batchHits.resize(positTestBatchSize);
+		if(pool == NULL)
+			pool = new PositThreadPool(threads);
+		PositDecoder* op = this;
+		pool->parallelFor(first, positTestBatchSize, [op, first](uint64_t i) {
+				uint64_t x = PositCoverage::decoderInput(i, op->N);
+				uint64_t out[6];
+				op->decodeOutputs(x, out);
+				op->batchHits[i-first] = PositCoverage::decoderHits(op->model, x);
+				// the test case too, with its mpz_class values, is built by the thread
+				TestCase* tc = new TestCase(op);
+				tc->addInput("Input", mpz_class((unsigned long) x));
+				static const char* const names[6] = {"Sign", "Reg", "Exp", "Frac", "z", "inf"};
+				for(int j = 0; j < 6; j++)
+					tc->addExpectedOutput(names[j], mpz_class((unsigned long) out[j]));
+				op->batchTests[i-first] = tc;
+			});
+		REPORT(DEBUG, "Computed test vectors " << first << " to " << first + positTestBatchSize - 1);
+	}
+
+
+	void PositDecoder::buildStandardTestCases(TestCaseList * tcl) {
+		if(N > 64)
+			return;
+		const uint64_t mask = model.nar() | model.maxpos();
+		vector<uint64_t> inputs = {model.zero(), model.nar(), ((uint64_t)1) << (N-2), model.minpos(), model.maxpos()};
+		// Each regime length, with the exponent and fraction all zeros or all ones
+		for(int run = 1; run < N-1; run++) {
+			int rest = N-2-run;
+			for(int ones = 0; ones < 2; ones++) {
+				uint64_t regime = ((ones ? (((uint64_t)1) << run) - 1 : 0) << 1 | !ones) << rest;
+				inputs.push_back(regime);
+				inputs.push_back(regime | ((((uint64_t)1) << rest) - 1));
+			}
+		}
+		// The opposites: the 2's complement of zero fields carries into the regime
+		size_t n = inputs.size();
+		for(size_t j = 2; j < n; j++)
+			inputs.push_back((-inputs[j]) & mask);
+		sort(inputs.begin(), inputs.end());
+		inputs.erase(unique(inputs.begin(), inputs.end()), inputs.end());
+
+		// with varEs every value of the ES port, those above es included
+		for(int e = (varEs ? 0 : es); e <= (varEs ? (1 << intlog2(es)) - 1 : es); e++)
+			for(uint64_t x : inputs) {
+				TestCase* tc = new TestCase(this);
+				tc->addInput("Input", mpz_class((unsigned long) x));
+				if(varEs)
+					tc->addInput("ES", mpz_class(e));
+				emulate(tc);
+				tcl->add(tc);
+			}
+	}
 
 
 
@@ -185,13 +455,21 @@ namespace flopoco {
 		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
 		int es;
 		UserInterface::parsePositiveInt(args, "es", &es);
-		return new PositDecoder(target, N, es);
+		int threads;
+		UserInterface::parsePositiveInt(args, "threads", &threads);
+		int arch;
+		UserInterface::parsePositiveInt(args, "arch", &arch);
+		bool varEs;
+		UserInterface::parseBoolean(args, "varEs", &varEs);
+		bool report;
+		UserInterface::parseBoolean(args, "report", &report);
+		return new PositDecoder(target, N, es, threads, arch, varEs, report);
 		
 	}
 	
 	void PositDecoder::registerFactory(){
 		UserInterface::add("PositDecoder", // name
-											 "A posit decoder with a single architecture.", // description, string
+											 "A posit decoder, with two architectures.", // description, string
 											 "Posit", // category, from the list defined in UserInterface.cpp
 											 "", //seeAlso
 											 // Now comes the parameter description string.
@@ -199,7 +477,11 @@ namespace flopoco {
 											 // Syntax is: a semicolon-separated list of parameterDescription;
 											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString 
 											 "N(int)=8: A first parameter, here used as the input size; \
-                        					 es(int): A second parameter, here used as the exponent size",
+                        					 es(int): A second parameter, here used as the exponent size; \
+                        					 threads(int)=0: number of threads generating the test vectors, 0 for all cores; \
+                        					 arch(int)=0: 0 counts the regime on the 2's complement of the input, 1 counts it on the raw bits and computes the 2's complement in parallel; \
+                        					 varEs(bool)=false: es is the largest exponent size, the actual one being the ES input, Exp being then right-aligned and Frac as wide as for es=0; \
+                        					 report(bool)=false: write the estimated pipeline depth, delays and resources of each stage to <name>.json",
 											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
 											 "Feel free to experiment with its code, it will not break anything in FloPoCo. <br> Also see the developper manual in the doc/ directory of FloPoCo.",
 											 PositDecoder::parseArguments
@@ -21,6 +21,11 @@
 
 //#include "../Operator.hpp"
 #include "../Target.hpp"
+#include "PositModel.hpp"
+#include "PositReport.hpp"
+#include "PositCModel.hpp"
+#include "PositCoverage.hpp"
+#include "PositTestVectors.hpp"
 
 /* This file contains a lot of useful functions to manipulate vhdl */
 #include "utils.hpp"
@@ -51,6 +56,34 @@ namespace flopoco {
 		int sizeRegime;
 		int sizeFraction;
 
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** Worker threads for test vector generation, 0 for all cores */
+		int threads;
+		/** 0: regime counted on the 2's complement of the input,
+		    1: regime counted on the raw bits, the 2's complement being computed in parallel */
+		int arch;
+		/** es is the largest exponent size, the actual one being the ES input */
+		bool varEs;
+		/** Software models for each exponent size up to es, when varEs */
+		vector<PositModel> models;
+		/** The threads, started with the first batch */
+		PositThreadPool* pool;
+		/** Current batch of test vectors, starting at test batchFirst: the test cases are
+		    built by the threads, and handed over to the TestBench one by one */
+		uint64_t batchFirst;
+		vector<TestCase*> batchTests;
+		/** The coverage bins of each test of the batch */
+		vector<uint32_t> batchHits;
+		/** The paths reached by the random tests so far */
+		PositCoverage coverage;
+
+		/** Compute the batch of test vectors starting at test first, in parallel */
+		void fillBatch(uint64_t first);
+
+		/** Estimated delays and resources, stage by stage */
+		PositReport costs;
 
 	public:
 		// definition of some function for the operator    
@@ -58,25 +91,49 @@ namespace flopoco {
 		/** The constructor 
 		    * @param N The size of the inputs.
 		    * @param es The width of the exponent.
+		    * @param threads The number of threads generating test vectors, 0 for all cores.
+		    * @param arch The architecture, 0 for the 2's complement before the regime count, 1 for the count on the raw bits.
+		    * @param varEs es is the largest exponent size, the actual one being the ES input.
+		    * @param report Write the estimated delays and resources to <name>.json.
 		    */
-		PositDecoder(Target* target,int N = 8, int es = 1, map<string, double> inputDelays = emptyDelayMap);
+		PositDecoder(Target* target,int N = 8, int es = 1, int threads = 0, int arch = 0, bool varEs = false, bool report = false, map<string, double> inputDelays = emptyDelayMap);
 
 		// destructor
-		~PositDecoder() {};
+		~PositDecoder();
+
+		/** Decode x the way the hardware does, outputs in the order Sign, Reg, Exp, Frac, z, inf.
+		    esIn is the exponent size when varEs */
+		void decodeOutputs(uint64_t x, uint64_t* out, int esIn = 0) const;
+
+		/** The estimated delays and resources */
+		const PositReport& getReport() const {return costs;}
+
+		/** The paths reached by the random tests so far */
+		const PositCoverage& getCoverage() const {return coverage;}
+
+		/** Describe the signals to a C++ model, for arch 0 and a fixed es
+		    * @param prefix Prepended to the names of the signals.
+		    * @param input The C++ expression of Input.
+		    * @param cycle The cycle of Input in the model.
+		    */
+		void cModel(PositCModel& m, string prefix, string input, int cycle);
 
 
 		// Below all the functions needed to test the operator
 		/* the emulate function is used to simulate in software the operator
 		   in order to compare this result with those outputed by the vhdl opertator */
-//		void emulate(TestCase * tc);
+		void emulate(TestCase * tc);
 
-		/* function used to create Standard testCase defined by the developper */
-//		void buildStandardTestCases(TestCaseList* tcl);
+		/* function used to create Standard testCase defined by the developper:
+		   the special values, and each regime length with the fields all zeros or all ones */
+		void buildStandardTestCases(TestCaseList* tcl);
 
 
 		/* function used to bias the (uniform by default) random test generator
-		   See FPExp.cpp for an example */
-//		TestCase* buildRandomTestCase(int i);
+		   See FPExp.cpp for an example
+		   For N <= 64 tests are computed by batches on several threads, biased towards
+		   long regimes and special values (see PositCoverage), and the paths they reach are reported */
+		TestCase* buildRandomTestCase(int i);
 
 		/** Factory method that parses arguments and calls the constructor */
 		static OperatorPtr parseArguments(Target *target , vector<string> &args);
@@ -0,0 +1,233 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+#include "PositSeedTable.hpp"
+
+// include the header of the Operator
+#include "PositDiv.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositDiv::PositDiv(Target* target, int N, int es, int arch, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), arch(arch), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositDiv";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositDiv_" << N << "_" << es;
+		if(arch == 1)
+			name << "_nr";
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+		// The fraction bits after the hidden bit
+		int F = FracSize-1;
+		// P+1 quotient bits after the point leave at least P = N-es-1 after normalization:
+		// the N-es-3 fraction bits a posit may keep, the guard and the round bits
+		int P = N-es-1;
+
+		if(arch < 0 || arch > 1)
+			THROWERROR("arch must be 0 or 1");
+		if(arch == 1 && F < 1)
+			THROWERROR("arch=1 indexes its seed table with the fraction of InputB, it needs N >= es+4");
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "InputA", N);
+		addInput  ( "InputB", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositDiv \n");
+		REPORT(DETAILED, "this operator has received three parameters " << N << ", " << es << " and " << arch);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		string decParams = "N=" + to_string(N) + " es=" + to_string(es);
+		PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", decParams, "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+		PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", decParams, "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoderA->getOutputDelay("Reg"));
+		syncCycleFromSignal("reg_B");
+		setCriticalPath(decoderB->getOutputDelay("Reg"));
+
+		addComment("Gather scale factors");
+		for(string op : {"A", "B"}) {
+			vhdl << tab << declare("sf_" + op, RegSize+es) << " <= reg_" << op;
+			if (es>0) vhdl << " & exp_" << op;
+			vhdl << ";" << endl;
+		}
+
+	//=========================================================================|
+		addFullComment("Sign and Special Cases Computation");
+	// ========================================================================|
+
+		vhdl << tab << declare("sign") << " <= sign_A XOR sign_B;" << endl;
+		addComment("A division by zero is NaR, as are those involving NaR");
+		vhdl << tab << declare("z") << " <= z_A;" << endl;
+		vhdl << tab << declare("inf") << " <= inf_A OR inf_B OR z_B;" << endl;
+
+	//=========================================================================|
+		addFullComment("Divide the fractions");
+	// ========================================================================|
+
+		if(arch == 0) {
+			addComment("Restoring division, one quotient bit per step: the partial remainder stays below 2*frac_B");
+			vhdl << tab << declare("rem_0", F+2) << " <= '0' & frac_A;" << endl;
+			for(int j = 0; j <= P+1; j++) {
+				string r = "rem_" + to_string(j);
+				string d = "diff_" + to_string(j);
+				string q = "q_" + to_string(j);
+				manageCriticalPath(target->localWireDelay() + target->adderDelay(F+3) + target->lutDelay());
+				vhdl << tab << declare(d, F+3) << " <= ('0' & " << r << ") - (\"00\" & frac_B);" << endl;
+				vhdl << tab << declare(q) << " <= not " << d << of(F+2) << ";" << endl;
+				vhdl << tab << declare("rem_" + to_string(j+1), F+2) << " <= " << d << range(F, 0) << " & '0' when " << q << " = '1' else "
+												<< r << range(F, 0) << " & '0';" << endl;
+			}
+			vhdl << tab << declare("quo", P+2) << " <= ";
+			for(int j = 0; j <= P+1; j++)
+				vhdl << (j > 0 ? " & " : "") << "q_" << j;
+			vhdl << ";" << endl;
+			vhdl << tab << declare("sticky") << " <= '0' when rem_" << P+2 << " = 0 else '1';" << endl;
+		}
+		else {
+			// The seed is indexed by t fraction bits of frac_B, and has t+2 fraction bits
+			int t = min(F, 10);
+			int wS = t+2;
+			// y has wY fraction bits: the quotient estimate below needs an error of 1/frac_B under 2^-(P+3)
+			int wY = P+6;
+			// The error of y_{k+1} is d*e_k^2 plus those of the two truncated products
+			double err = ldexp(1.0, -(t+1)) + ldexp(1.0, -(wS+1));
+			int iterations = 0;
+			while(err >= ldexp(1.0, -(P+3))) {
+				err = 2*err*err + ldexp(1.0, 1-wY);
+				iterations++;
+			}
+			REPORT(DETAILED, "Seed table of " << t << " input bits, " << iterations << " Newton-Raphson iterations");
+
+			vhdl << tab << declare("seed_idx", t) << " <= frac_B" << range(F-1, F-t) << ";" << endl;
+			PositSeedTable* seed = (PositSeedTable*) newInstance("PositSeedTable", "seed_table", "wIn=" + to_string(t) + " wOut=" + to_string(wS+1), "X=>seed_idx;Y=>seed");
+			syncCycleFromSignal("seed");
+			setCriticalPath(seed->getOutputDelay("Y"));
+			vhdl << tab << declare("y_0", wY+1) << " <= seed & " << zg(wY-wS) << ";" << endl;
+
+			for(int k = 0; k < iterations; k++) {
+				string y = "y_" + to_string(k);
+				string k1 = to_string(k+1);
+				addComment("y_" + k1 + " = y_" + to_string(k) + "*(2 - frac_B*y_" + to_string(k) + ")");
+				multiply("frac_B", F+1, y, wY+1, wY+2, "dy_" + k1);
+				manageCriticalPath(target->localWireDelay() + target->adderDelay(wY+2));
+				vhdl << tab << declare("e_" + k1, wY+2) << " <= \"" << unsignedBinary(mpz_class(2) << wY, wY+2) << "\" - dy_" << k1 << ";" << endl;
+				multiply(y, wY+1, "e_" + k1, wY+2, wY+3, "ye_" + k1);
+				vhdl << tab << declare("y_" + k1, wY+1) << " <= ye_" << k1 << range(wY, 0) << ";" << endl;
+			}
+
+			addComment("Quotient estimate with two more bits, truncated: within one of the truncated quotient");
+			multiply("frac_A", F+1, "y_" + to_string(iterations), wY+1, P+5, "xy");
+			vhdl << tab << declare("quo_a", P+2) << " <= xy" << range(P+3, 2) << ";" << endl;
+
+			addComment("The remainder frac_A*2^(P+1) - quo_a*frac_B is within (-frac_B,2*frac_B):");
+			addComment("its F+3 low bits are enough, and those of frac_A*2^(P+1) are zeros");
+			vhdl << tab << declare("quo_l", F+3) << " <= quo_a" << range(F+2, 0) << ";" << endl;
+			multiply("quo_l", F+3, "frac_B", F+1, 0, "qd");
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(F+3));
+			vhdl << tab << declare("rem_a", F+3) << " <= " << zg(F+3) << " - qd" << range(F+2, 0) << ";" << endl;
+
+			addComment("Correct the quotient by one ulp");
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(F+3));
+			vhdl << tab << declare("rem_m", F+3) << " <= rem_a - (\"00\" & frac_B);" << endl;
+			vhdl << tab << declare("rem_p", F+3) << " <= rem_a + (\"00\" & frac_B);" << endl;
+			vhdl << tab << declare("quo_dec") << " <= rem_a" << of(F+2) << ";" << endl;
+			vhdl << tab << declare("quo_inc") << " <= not rem_a" << of(F+2) << " and not rem_m" << of(F+2) << ";" << endl;
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(P+2) + target->lutDelay());
+			vhdl << tab << declare("quo", P+2) << " <= quo_a - 1 when quo_dec = '1' else"
+											<< " quo_a + 1 when quo_inc = '1' else quo_a;" << endl;
+			vhdl << tab << declare("rem_c", F+3) << " <= rem_p when quo_dec = '1' else"
+											<< " rem_m when quo_inc = '1' else rem_a;" << endl;
+			vhdl << tab << declare("sticky") << " <= '0' when rem_c = 0 else '1';" << endl;
+		}
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("Adjust for a quotient below 1");
+		vhdl << tab << declare("lt1") << " <= not quo" << of(P+1) << ";" << endl;
+		vhdl << tab << declare("normFrac", P+3) << " <= quo & sticky when lt1 = '0' else"
+											<< " quo" << range(P, 0) << " & sticky & '0';" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(RegSize+es+1));
+		vhdl << tab << declare("sf_div", RegSize+es+1) << " <= (sf_A(sf_A'high) & sf_A) - (sf_B(sf_B'high) & sf_B) - lt1;" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(RegSize+es+1) + " wF=" + to_string(P+3), "Sign=>sign;SF=>sf_div;Frac=>normFrac;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	void PositDiv::multiply(string x, int wX, string y, int wY, int wOut, string r) {
+		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", r + "_mult", "wX=" + to_string(wX) + " wY=" + to_string(wY) + " wOut=" + to_string(wOut), "X=>" + x + ";Y=>" + y + ";R=>" + r);
+		syncCycleFromSignal(r);
+		setCriticalPath(mult->getOutputDelay("R"));
+	}
+
+
+	void PositDiv::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "InputA" );
+		mpz_class svY = tc->getInputValue ( "InputB" );
+		tc->addExpectedOutput ( "Output", model.div(svX, svY) );
+	}
+
+
+	OperatorPtr PositDiv::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int arch;
+		UserInterface::parsePositiveInt(args, "arch", &arch);
+		return new PositDiv(target, N, es, arch);
+	}
+
+
+	void PositDiv::registerFactory(){
+		UserInterface::add("PositDiv", // name
+											 "A posit divider, with a digit-recurrence and a Newton-Raphson architecture.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult, PositSqrt", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size; \
+                        					 arch(int)=0: 0 for a restoring digit recurrence with one adder per quotient bit, 1 for Newton-Raphson iterations on IntMultiplier from a seed table",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even. A division by zero is NaR.",
+											 PositDiv::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,86 @@
+/*
+  Posit divider.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_DIV_HPP
+#define POSIT_DIV_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The quotient of two N-bit posits, correctly rounded.
+	    The operands are unpacked by two PositDecoder, and the quotient of the
+	    fractions, in (1/2,2), is computed with N-es quotient bits and a sticky
+	    bit, then normalized and rounded by PositEncoder as in PositMult.
+	    Two architectures, both pipelined to one division per cycle:
+	    arch 0 is a restoring digit recurrence, one quotient bit and one adder
+	    per step, cheap but with a latency that grows with N;
+	    arch 1 computes 1/frac_B by Newton-Raphson iterations from a seed table,
+	    multiplies it by frac_A, and corrects the quotient by one ulp from its
+	    remainder: a few IntMultiplier instead of N adders, for a shorter latency. */
+	class PositDiv : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** 0 for the digit recurrence, 1 for Newton-Raphson */
+		int arch;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** Declares r, the product of x of wX bits by y of wY bits, truncated to its wOut leading bits (0 for all) */
+		void multiply(string x, int wX, string y, int wY, int wOut, string r);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param arch The architecture, 0 for the digit recurrence, 1 for Newton-Raphson.
+		    */
+		PositDiv(Target* target, int N = 8, int es = 1, int arch = 0, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositDiv() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
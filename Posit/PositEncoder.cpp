@@ -0,0 +1,349 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "PositTestVectors.hpp"
+#include "../ShiftersEtc/Shifters_signed.hpp"
+
+// include the header of the Operator
+#include "PositEncoder.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositEncoder::PositEncoder(Target* target, int N, int es, int wSF, int wF, bool varEs, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), wSF(wSF), wF(wF), varEs(varEs), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositEncoder";
+
+		RegSize = intlog2(N);
+		// the scale factor of PositDecoder: its regime and exponent
+		int wSFDec = intlog2(N-1)+1+es;
+		if(this->wSF == 0)
+			this->wSF = wSFDec;
+		if(this->wF == 0)
+			this->wF = (varEs ? N-2 : N-es-2);
+		wSF = this->wSF;
+		wF = this->wF;
+		if(wSF < wSFDec)
+			THROWERROR("SF must be at least as wide as the scale factor of PositDecoder, " << wSFDec << " bits");
+		if(varEs && (es < 1 || es > N-4))
+			THROWERROR("varEs needs 1 <= es <= N-4, got es=" << es);
+		if(varEs)
+			for(int e = 0; e <= es; e++)
+				models.push_back(PositModel(N, e));
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositEncoder_" << N << "_" << es << "_" << wSF << "_" << wF;
+		if(varEs)
+			name << "_vares";
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Sign" );
+		addInput  ( "SF"	, wSF);
+		addInput  ( "Frac"	, wF);
+		addInput  ( "z" );
+		addInput  ( "inf" );
+		if(varEs)
+			addInput  ( "ES"	, intlog2(es));
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositEncoder \n");
+		REPORT(DETAILED, "this operator has received four parameters " << N << ", " << es << ", " << wSF << " and " << wF);
+
+		// The packing shifter must leave room for the N-1 bits, G, R and at least one sticky bit
+		int wFrac = max(wF-1, N-es);
+
+	//=========================================================================|
+		addFullComment("Compute Regime and Exponent value");
+	// ========================================================================|
+		int wR = (varEs ? wSF : wSF-es);
+		// the signals in flight after each stage, plus the exponent bits when es > 0
+		auto withExp = [es](vector<string> inFlight, string exp) {
+			if(es > 0)
+				inFlight.push_back(exp);
+			return inFlight;
+		};
+
+		vhdl << tab << declare("nzero") << " <= NOT z;" << endl;
+		vhdl << tab << declare("sf_sign") << " <= SF(SF'high);" << endl;
+		addComment("Unpack scaling factors");
+		if (varEs) {
+			// The exponent is the low ES bits of SF, right-aligned, and the regime SF >> ES.
+			// ES > es, which the port width allows when es+1 is not a power of 2, is taken as es
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << declare("ExpBits", es) << " <= ";
+			for(int e = es; e > 0; e--)
+				vhdl << (e < es ? zg(es-e) + " & " : "") << "SF" << range(e-1, 0) << " when ES " << (e == es ? ">= " : "= ") << e << " else ";
+			vhdl << zg(es) << ";" << endl;
+			vhdl << tab << declare("RegimeAns_tmp", wR) << " <= ";
+			for(int e = es; e > 0; e--) {
+				for(int i = 0; i < e; i++)
+					vhdl << "sf_sign & ";
+				vhdl << "SF" << range(wSF-1, e) << " when ES " << (e == es ? ">= " : "= ") << e << " else ";
+			}
+			vhdl << "SF;" << endl;
+			costs.stage(this, "exponent size multiplexers", wR+es, withExp({"RegimeAns_tmp", "sf_sign", "Frac", "Sign", "z", "inf"}, "ExpBits"));
+		}
+		else {
+			if (es>0)
+				vhdl << tab << declare("ExpBits", es) << " <= SF" << range(es-1,0) << ";" << endl;
+			vhdl << tab << declare("RegimeAns_tmp", wR) << " <= SF" << range(wSF-1,es) << ";" << endl;
+		}
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wR));
+		addComment("Get Regime's absolute value");
+		vhdl << tab << declare("RegimeAns", wR) << " <= (NOT RegimeAns_tmp)+1 when sf_sign = '1' else RegimeAns_tmp;" << endl;
+		costs.stage(this, "regime absolute value", wR, withExp({"RegimeAns", "sf_sign", "Frac", "Sign", "z", "inf"}, "ExpBits"));
+
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(wR) + target->lutDelay());
+		addComment("Check for Regime overflow");
+		vhdl << tab << declare("ovf_reg") << " <= '1' when RegimeAns > " << N-1 << " else '0';" << endl;
+		vhdl << tab << declare("FinalRegime", RegSize) << " <= \"" << unsignedBinary(mpz_class(N-1), RegSize) << "\" when ovf_reg = '1' else "
+														<< "RegimeAns" << range(RegSize-1, 0) << ";" << endl;
+		costs.stage(this, "regime overflow", PositReport::comparatorLuts(target, wR) + RegSize, withExp({"FinalRegime", "ovf_reg", "sf_sign", "Frac", "Sign", "z", "inf"}, "ExpBits"));
+
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(RegSize));
+		vhdl << tab << declare("ovf_regF") << " <= '1' when FinalRegime = \"" << unsignedBinary(mpz_class(N-1), RegSize) << "\" else '0';" << endl;
+		costs.stage(this, "regime saturation", PositReport::comparatorLuts(target, RegSize), withExp({"FinalRegime", "ovf_reg", "ovf_regF", "sf_sign", "Frac", "Sign", "z", "inf"}, "ExpBits"));
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		if (es>0){
+			vhdl << tab << declare("FinalExp", es) << " <= " << zg(es) << " when ((ovf_reg = '1') OR (ovf_regF = '1') OR (nzero='0')) else "
+														<< "ExpBits;" << endl;
+		}
+
+	//=========================================================================|
+		addFullComment("Packing Stage 1");
+	// ========================================================================|
+
+		costs.stage(this, "final exponent", es, withExp({"FinalRegime", "ovf_reg", "ovf_regF", "sf_sign", "Frac", "Sign", "z", "inf"}, "FinalExp"));
+
+		vhdl << tab << declare("FracBits", wFrac) << " <= ";
+		if (wF > 1)
+			vhdl << "Frac" << range(wF-2, 0) << (wFrac > wF-1 ? " & " : "");
+		if (wFrac > wF-1)
+			vhdl << zg(wFrac-(wF-1));
+		vhdl << ";" << endl;
+
+		if (varEs) {
+			// FinalExp < 2^ES: its es-ES leading zeros are shifted out, the fraction follows the ES exponent bits
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+			vhdl << tab << declare("ExpFrac", es+wFrac) << " <= FinalExp & FracBits;" << endl;
+			vhdl << tab << declare("ExpFrac_sh", es+wFrac) << " <= ";
+			for(int e = 0; e < es; e++)
+				vhdl << "ExpFrac" << range(e+wFrac-1, 0) << " & " << zg(es-e) << " when ES = " << e << " else ";
+			vhdl << "ExpFrac;" << endl;
+			costs.stage(this, "exponent size alignment", es+wFrac, {"ExpFrac_sh", "FinalRegime", "ovf_reg", "ovf_regF", "sf_sign", "Sign", "z", "inf"});
+			vhdl << tab << declare("tmp1", 2+es+wFrac) << " <= nzero & '0' & ExpFrac_sh;" << endl;
+			vhdl << tab << declare("tmp2", 2+es+wFrac) << " <= '0' & nzero & ExpFrac_sh;" << endl;
+		}
+		else {
+			vhdl << tab << declare("tmp1", 2+es+wFrac) << " <= nzero & '0' ";
+			if (es>0)
+				vhdl << "& FinalExp ";
+			vhdl << "& FracBits;" << endl;
+			vhdl << tab << declare("tmp2", 2+es+wFrac) << " <= '0' & nzero ";
+			if (es>0)
+				vhdl << "& FinalExp ";
+			vhdl << "& FracBits;" << endl;
+		}
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(RegSize) + target->lutDelay());
+		vhdl << tab << declare("shift_neg", RegSize) << " <= FinalRegime - 2 when (ovf_regF = '1') else"
+													 << " FinalRegime - 1;" << endl;
+		vhdl << tab << declare("shift_pos", RegSize) << " <= FinalRegime - 1 when (ovf_regF = '1') else"
+													 << " FinalRegime;" << endl;
+
+		vhdl << tab << declare("shifter_in", 2+es+wFrac) << " <= tmp2 when sf_sign = '1' else"
+																<< " tmp1;" << endl;
+		vhdl << tab << declare("shifter_S", RegSize) << " <= shift_neg when sf_sign = '1' else"
+													<< " shift_pos;" << endl;
+		costs.stage(this, "regime shift amount", 2*RegSize + 2+es+wFrac, {"shifter_in", "shifter_S", "ovf_reg", "ovf_regF", "Sign", "z", "inf"});
+		Shifter_signed* rightShifter = (Shifter_signed*) newInstance("Shifter_signed", "RightShifterComponent", "wIn=" + to_string(2+es+wFrac) + " maxShift=" + to_string(N) + " dir=1", "X=>shifter_in;S=>shifter_S;R=>shifter_out");
+		syncCycleFromSignal("shifter_out");
+		setCriticalPath(rightShifter->getOutputDelay("R"));
+		costs.component(this, "regime packing shift", rightShifter, PositReport::shifterLuts(target, 2+es+wFrac, N), 0, {"shifter_out", "ovf_reg", "ovf_regF", "Sign", "z", "inf"});
+
+		int shift_size = getSignalByName("shifter_out")->width();
+		vhdl << tab << declare("tmp_ans", N-1) << " <= shifter_out" << range(shift_size-1, shift_size-(N-1)) << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Packing Stage 2 - Unbiased Rounding");
+	// ========================================================================|
+		// Rounding implementation using L,G,R,S bits
+		vhdl << tab << declare("LSB") << " <= shifter_out" << of(shift_size-(N-1)) << ";" << endl;
+		vhdl << tab << declare("G") << " <= shifter_out" << of(shift_size-(N-1)-1) << ";" << endl;
+		vhdl << tab << declare("R") << " <= shifter_out" << of(shift_size-(N-1)-2) << ";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->eqConstComparatorDelay(shift_size-(N-1)-2) + target->lutDelay());
+		vhdl << tab << declare("S") << " <= '0' when shifter_out" << range(shift_size-(N-1)-3, 0) << " = 0 else '1';" << endl;
+		costs.stage(this, "sticky bit", PositReport::comparatorLuts(target, shift_size-(N-1)-2), {"tmp_ans", "LSB", "G", "R", "S", "ovf_reg", "ovf_regF", "Sign", "z", "inf"});
+
+		vhdl << tab << declare("round") << " <= G AND (LSB OR R OR S) when NOT((ovf_reg OR ovf_regF) = '1') else '0';" << endl;
+
+		// A single adder rounds and restores the sign: -(tmp_ans + round) = NOT(tmp_ans) + NOT(round)
+		manageCriticalPath(target->localWireDelay() + target->lutDelay() + target->adderDelay(N));
+		vhdl << tab << declare("rep_sgn", N-1) << " <= (others => Sign);" << endl;
+		vhdl << tab << declare("rounded", N) << " <= (Sign & (tmp_ans XOR rep_sgn)) + (round XOR Sign);" << endl;
+		costs.stage(this, "rounding and sign", N+1, {"rounded", "z", "inf"});
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		vhdl << tab << "Output <= '1' & " << zg(N-1) << " when inf = '1' else "
+							<< zg(N) << " when z = '1' else"
+							<< " rounded;" << endl;
+		costs.stage(this, "special cases", N, {"Output"});
+
+	};
+
+
+	mpz_class PositEncoder::encode(mpz_class sign, mpz_class sf, mpz_class frac, mpz_class z, mpz_class inf, int e) const {
+		const PositModel& m = (varEs ? models[e] : model);
+		if(inf == 1)
+			return mpz_class(1) << (N-1);
+		if(z == 1)
+			return 0;
+		if(sf >= (mpz_class(1) << (wSF-1)))
+			sf -= mpz_class(1) << wSF;
+		mpz_class sig = frac | (mpz_class(1) << (wF-1));
+		return m.encodeMpz(sign == 1, sf.get_si(), sig, wF-1, false);
+	}
+
+
+	void PositEncoder::cModel(PositCModel& m, string prefix, vector<string> inputs, int cycle) {
+		if(varEs)
+			THROWERROR("the C++ model is only available for a fixed es");
+		// the C++ reference to a signal, and the cycle of a signal in the model
+		auto s = [prefix](string name) {return PositCModel::ref(prefix + name);};
+		auto c = [this, cycle](string name) {return cycle + getSignalByName(name)->getCycle();};
+		int wFrac = max(wF-1, N-es);
+		int wR = wSF-es;
+		int wIn = 2+es+wFrac;
+		int shift_size = getSignalByName("shifter_out")->width();
+		string nm1 = to_string(N-1);
+
+		m.signal(prefix + "Sign", 1, cycle, inputs[0]);
+		m.signal(prefix + "SF", wSF, cycle, inputs[1]);
+		m.signal(prefix + "Frac", wF, cycle, inputs[2]);
+		m.signal(prefix + "z", 1, cycle, inputs[3]);
+		m.signal(prefix + "inf", 1, cycle, inputs[4]);
+		m.signal(prefix + "nzero", 1, c("nzero"), "!" + s("z"));
+		m.signal(prefix + "sf_sign", 1, c("sf_sign"), s("SF") + " >> " + to_string(wSF-1));
+		if(es > 0)
+			m.signal(prefix + "ExpBits", es, c("ExpBits"), s("SF"));
+		m.signal(prefix + "RegimeAns_tmp", wR, c("RegimeAns_tmp"), s("SF") + " >> " + to_string(es));
+		m.signal(prefix + "RegimeAns", wR, c("RegimeAns"), s("sf_sign") + " ? ~" + s("RegimeAns_tmp") + " + 1 : " + s("RegimeAns_tmp"));
+		m.signal(prefix + "ovf_reg", 1, c("ovf_reg"), s("RegimeAns") + " > " + nm1);
+		m.signal(prefix + "FinalRegime", RegSize, c("FinalRegime"), s("ovf_reg") + " ? " + nm1 + " : " + s("RegimeAns"));
+		m.signal(prefix + "ovf_regF", 1, c("ovf_regF"), s("FinalRegime") + " == " + nm1);
+		string finalExp = "0";
+		if(es > 0) {
+			m.signal(prefix + "FinalExp", es, c("FinalExp"), s("ovf_reg") + " | " + s("ovf_regF") + " | !" + s("nzero") + " ? 0 : " + s("ExpBits"));
+			finalExp = "(" + s("FinalExp") + " << " + to_string(wFrac) + ")";
+		}
+		m.signal(prefix + "FracBits", wFrac, c("FracBits"), (wF > 1 ? "(" + s("Frac") + " & " + PositCModel::mask(wF-1) + ") << " + to_string(wFrac-(wF-1)) : string("0")));
+		m.signal(prefix + "tmp1", wIn, c("tmp1"), "(" + s("nzero") + " << " + to_string(1+es+wFrac) + ") | " + finalExp + " | " + s("FracBits"));
+		m.signal(prefix + "tmp2", wIn, c("tmp2"), "(" + s("nzero") + " << " + to_string(es+wFrac) + ") | " + finalExp + " | " + s("FracBits"));
+		m.signal(prefix + "shift_neg", RegSize, c("shift_neg"), s("FinalRegime") + " - (" + s("ovf_regF") + " ? 2 : 1)");
+		m.signal(prefix + "shift_pos", RegSize, c("shift_pos"), s("FinalRegime") + " - (" + s("ovf_regF") + " ? 1 : 0)");
+		m.signal(prefix + "shifter_in", wIn, c("shifter_in"), s("sf_sign") + " ? " + s("tmp2") + " : " + s("tmp1"));
+		m.signal(prefix + "shifter_S", RegSize, c("shifter_S"), s("sf_sign") + " ? " + s("shift_neg") + " : " + s("shift_pos"));
+		// Shifter_signed: the input on top of shift_size bits, shifted right with sign extension
+		m.signal(prefix + "shifter_out", shift_size, c("shifter_out"),
+				 "((" + s("shifter_in") + " << " + to_string(shift_size-wIn) + ") >> " + s("shifter_S") + ") | "
+				 + "(" + s("shifter_in") + " >> " + to_string(wIn-1) + " ? " + PositCModel::mask(shift_size) + " ^ (" + PositCModel::mask(shift_size) + " >> " + s("shifter_S") + ") : 0)");
+		m.signal(prefix + "tmp_ans", N-1, c("tmp_ans"), s("shifter_out") + " >> " + to_string(shift_size-(N-1)));
+		m.signal(prefix + "LSB", 1, c("LSB"), s("shifter_out") + " >> " + to_string(shift_size-(N-1)));
+		m.signal(prefix + "G", 1, c("G"), s("shifter_out") + " >> " + to_string(shift_size-(N-1)-1));
+		m.signal(prefix + "R", 1, c("R"), s("shifter_out") + " >> " + to_string(shift_size-(N-1)-2));
+		m.signal(prefix + "S", 1, c("S"), "(" + s("shifter_out") + " & " + PositCModel::mask(shift_size-(N-1)-2) + ") != 0");
+		m.signal(prefix + "round", 1, c("round"), s("ovf_reg") + " | " + s("ovf_regF") + " ? 0 : " + s("G") + " & (" + s("LSB") + " | " + s("R") + " | " + s("S") + ")");
+		m.signal(prefix + "rounded", N, c("rounded"), "((" + s("Sign") + " << " + nm1 + ") | (" + s("tmp_ans") + " ^ (" + s("Sign") + " ? " + PositCModel::mask(N-1) + " : 0))) + (" + s("round") + " ^ " + s("Sign") + ")");
+		m.signal(prefix + "Output", N, c("Output"), s("inf") + " ? " + PositCModel::mask(1) + " << " + nm1 + " : " + s("z") + " ? 0 : " + s("rounded"));
+	}
+
+
+	void PositEncoder::emulate(TestCase * tc) {
+		// get the inputs from the TestCase
+		mpz_class svS = tc->getInputValue ( "Sign" );
+		mpz_class svSF = tc->getInputValue ( "SF" );
+		mpz_class svF = tc->getInputValue ( "Frac" );
+		mpz_class svZ = tc->getInputValue ( "z" );
+		mpz_class svI = tc->getInputValue ( "inf" );
+
+		// complete the TestCase with this expected output
+		int e = (varEs ? min((int)tc->getInputValue ( "ES" ).get_si(), es) : 0);
+		tc->addExpectedOutput ( "Output", encode(svS, svSF, svF, svZ, svI, e) );
+	}
+
+
+	TestCase* PositEncoder::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		// scale factors up to one regime beyond maxpos and minpos, to exercise saturation
+		mpz_class range = mpz_class(2*N) << es;
+		mpz_class sf = getLargeRandom(wSF+8) % (2*range+1) - range;
+		if(sf < 0)
+			sf += mpz_class(1) << wSF;
+		sf = sf % (mpz_class(1) << wSF);
+		mpz_class special = getLargeRandom(4);
+		tc->addInput("Sign", getLargeRandom(1));
+		tc->addInput("SF", sf);
+		tc->addInput("Frac", getLargeRandom(wF-1) | (mpz_class(1) << (wF-1)));
+		tc->addInput("z", mpz_class(special == 0 ? 1 : 0));
+		tc->addInput("inf", mpz_class(special == 1 ? 1 : 0));
+		if(varEs)
+			tc->addInput("ES", PositTestVectors::randomEs(es));
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositEncoder::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int wSF;
+		UserInterface::parsePositiveInt(args, "wSF", &wSF);
+		int wF;
+		UserInterface::parsePositiveInt(args, "wF", &wF);
+		bool varEs;
+		UserInterface::parseBoolean(args, "varEs", &varEs);
+		return new PositEncoder(target, N, es, wSF, wF, varEs);
+	}
+
+
+	void PositEncoder::registerFactory(){
+		UserInterface::add("PositEncoder", // name
+											 "A posit encoder, the inverse of PositDecoder.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositDecoder", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The output size; \
+                        					 es(int): The exponent size; \
+                        					 wSF(int)=0: The width of the scale factor input, 0 for that of PositDecoder; \
+                        					 wF(int)=0: The width of the fraction input (hidden bit included), 0 for that of PositDecoder; \
+                        					 varEs(bool)=false: es is the largest exponent size, the actual one being the ES input",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even and saturates to minpos/maxpos. Inputs wider than those of PositDecoder allow packing exact results.",
+											 PositEncoder::parseArguments
+											 ) ;
+	}
+
+}//namespace
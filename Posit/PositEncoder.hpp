@@ -0,0 +1,111 @@
+/*
+  Posit encoder.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_ENCODER_HPP
+#define POSIT_ENCODER_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+#include "PositReport.hpp"
+#include "PositCModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** Packs a value in decoded form into an N-bit posit, with unbiased rounding.
+	    This is the inverse of PositDecoder: the decoded form is a sign, a scale
+	    factor SF (two's complement, the regime followed by the exponent), a
+	    fraction Frac with the hidden bit on top, and the z and inf flags.
+	    SF and Frac may be wider than those of PositDecoder, e.g. to pack the
+	    exact result of an arithmetic operator. */
+	class PositEncoder : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** The width of the scale factor input */
+		int wSF;
+		/** The width of the fraction input, hidden bit included */
+		int wF;
+
+		/** es is the largest exponent size, the actual one being the ES input */
+		bool varEs;
+
+		int RegSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+		/** Software models for each exponent size up to es, when varEs */
+		vector<PositModel> models;
+
+		/** Estimated delays and resources, stage by stage */
+		PositReport costs;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param wSF The width of SF, 0 for that of PositDecoder (intlog2(N-1)+1+es).
+		    * @param wF The width of Frac, 0 for that of PositDecoder (N-es-2).
+		    * @param varEs es is the largest exponent size, the actual one being the ES input.
+		    */
+		PositEncoder(Target* target, int N = 8, int es = 1, int wSF = 0, int wF = 0, bool varEs = false, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositEncoder() {};
+
+		/** The posit the hardware outputs for these inputs, SF as an unsigned bit pattern.
+		    e is the exponent size when varEs */
+		mpz_class encode(mpz_class sign, mpz_class sf, mpz_class frac, mpz_class z, mpz_class inf, int e = 0) const;
+
+		/** The estimated delays and resources */
+		const PositReport& getReport() const {return costs;}
+
+		/** Describe the signals to a C++ model, for a fixed es
+		    * @param prefix Prepended to the names of the signals.
+		    * @param inputs The C++ expressions of Sign, SF, Frac, z and inf.
+		    * @param cycle The cycle of the inputs in the model.
+		    */
+		void cModel(PositCModel& m, string prefix, vector<string> inputs, int cycle);
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator.
+		   The hidden bit of Frac is not read */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator:
+		   few special values, and scale factors around the range of the posits */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,241 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositFMA.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositFMA::PositFMA(Target* target, int N, int es, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositFMA";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositFMA_" << N << "_" << es ;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "InputA", N);
+		addInput  ( "InputB", N);
+		addInput  ( "InputC", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositFMA \n");
+		REPORT(DETAILED, "this operator has received two parameters " << N << " and " << es);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+
+		PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+		PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
+		PositDecoder* decoderC = (PositDecoder*) newInstance("PositDecoder", "decoderC", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputC;Sign=>sign_C;Reg=>reg_C;Exp=>exp_C;Frac=>frac_C;z=>z_C;inf=>inf_C");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoderA->getOutputDelay("Reg"));
+		syncCycleFromSignal("reg_B");
+		setCriticalPath(decoderB->getOutputDelay("Reg"));
+		syncCycleFromSignal("reg_C");
+		setCriticalPath(decoderC->getOutputDelay("Reg"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+
+		addComment("Gather scale factors");
+		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+		if (es>0) vhdl << " & exp_A";
+		vhdl << ";" << endl;
+		vhdl << tab << declare("sf_B", RegSize+es) << " <= reg_B";
+		if (es>0) vhdl << " & exp_B";
+		vhdl << ";" << endl;
+		vhdl << tab << declare("sf_C", RegSize+es) << " <= reg_C";
+		if (es>0) vhdl << " & exp_C";
+		vhdl << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Sign and Special Cases Computation");
+	// ========================================================================|
+
+		vhdl << tab << declare("sign_AB") << " <= sign_A XOR sign_B;" << endl;
+		vhdl << tab << declare("z_AB") << " <= z_A OR z_B;" << endl;
+		vhdl << tab << declare("inf") << " <= inf_A OR inf_B OR inf_C;" << endl;
+		vhdl << tab << declare("eff_sub") << " <= sign_AB XOR sign_C;" << endl;
+
+	//=========================================================================|
+		addFullComment("Multiply the fractions, add the exponent values");
+	// ========================================================================|
+
+		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", "mult", "wX=" + to_string(FracSize) + " wY=" + to_string(FracSize) + " wOut="+ to_string(0), "X=>frac_A;Y=>frac_B;R=>frac_mult");
+		syncCycleFromSignal("frac_mult");
+		setCriticalPath(mult->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		int mult_size = getSignalByName("frac_mult")->width();
+
+		addComment("Adjust for overflow");
+		vhdl << tab << declare("ovf_m") << " <= frac_mult(frac_mult'high);" << endl;
+		vhdl << tab << declare("normFrac", mult_size+1) << " <= frac_mult & '0' when ovf_m = '0' else"
+													<< " '0' & frac_mult;" << endl; // Equivalent to shift right ovf_m bits
+		vhdl << tab << declare("sf_mult", RegSize+es+1) << " <= (sf_A(sf_A'high) & sf_A) + (sf_B(sf_B'high) & sf_B) + ovf_m;" << endl;
+
+	//=========================================================================|
+		addFullComment("Align the addend to the exact product");
+	// ========================================================================|
+		// Both significands are on W bits with the hidden bit on top.
+		// The smaller operand is shifted right into W+2 extra bits: beyond that it
+		// is far below the rounding point and only matters as a nonzero tail
+		int wE = RegSize+es+1;
+		int W = mult_size;
+		int maxAlign = W+2;
+		int wShift = intlog2(maxAlign);
+
+		vhdl << tab << declare("sig_AB", W) << " <= normFrac" << range(W-1, 0) << ";" << endl;
+		vhdl << tab << declare("sig_C", W) << " <= frac_C & " << zg(W-FracSize) << ";" << endl;
+		vhdl << tab << declare("sf_C_ext", wE) << " <= sf_C(sf_C'high) & sf_C;" << endl;
+		vhdl << tab << declare("sf_diff", wE+1) << " <= (sf_mult(sf_mult'high) & sf_mult) - (sf_C_ext(sf_C_ext'high) & sf_C_ext);" << endl;
+		addComment("Swap when the addend is the larger operand, or when the product is zero");
+		vhdl << tab << declare("swap") << " <= z_AB OR (sf_diff(sf_diff'high) AND NOT z_C);" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+1));
+
+		vhdl << tab << declare("sig_X", W) << " <= sig_C when swap = '1' else sig_AB;" << endl;
+		vhdl << tab << declare("sig_Y", W) << " <= sig_AB when swap = '1' else sig_C;" << endl;
+		vhdl << tab << declare("sf_X", wE) << " <= sf_C_ext when swap = '1' else sf_mult;" << endl;
+		vhdl << tab << declare("sign_X") << " <= sign_C when swap = '1' else sign_AB;" << endl;
+		vhdl << tab << declare("shift_val", wE+1) << " <= (NOT sf_diff) + 1 when swap = '1' else sf_diff;" << endl;
+		addComment("Saturate the alignment, a zero operand may give a negative distance");
+		vhdl << tab << declare("shift_amt", wShift) << " <= \"" << unsignedBinary(mpz_class(maxAlign), wShift) << "\" when shift_val > " << maxAlign << " else"
+										<< " shift_val" << range(wShift-1, 0) << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wE+1));
+
+		vhdl << tab << declare("align_in", 2*W+2) << " <= sig_Y & " << zg(W+2) << ";" << endl;
+		Shifter* alignShifter = (Shifter*) newInstance("Shifter", "AlignShifter", "wIn=" + to_string(2*W+2) + " maxShift=" + to_string(maxAlign) + " dir=1", "X=>align_in;S=>shift_amt;R=>align_out");
+		syncCycleFromSignal("align_out");
+		setCriticalPath(alignShifter->getOutputDelay("R"));
+		int align_size = getSignalByName("align_out")->width();
+		vhdl << tab << declare("aligned_Y", 2*W+2) << " <= align_out" << range(align_size-1, align_size-(2*W+2)) << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Add the significands");
+	// ========================================================================|
+
+		vhdl << tab << declare("X_ext", 2*W+4) << " <= \"00\" & sig_X & " << zg(W+2) << ";" << endl;
+		vhdl << tab << declare("Y_ext", 2*W+4) << " <= \"00\" & aligned_Y;" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(2*W+4));
+		vhdl << tab << declare("sum", 2*W+4) << " <= X_ext - Y_ext when eff_sub = '1' else X_ext + Y_ext;" << endl;
+
+		addComment("The difference is negative only when both scale factors are equal");
+		vhdl << tab << declare("sum_sign") << " <= sum(sum'high);" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(2*W+3));
+		vhdl << tab << declare("abs_sum", 2*W+3) << " <= (NOT sum" << range(2*W+2, 0) << ") + 1 when sum_sign = '1' else"
+										<< " sum" << range(2*W+2, 0) << ";" << endl;
+		vhdl << tab << declare("sign") << " <= sign_X XOR sum_sign;" << endl;
+		vhdl << tab << declare("nzero") << " <= '0' when abs_sum = 0 else '1';" << endl;
+
+	//=========================================================================|
+		addFullComment("Normalization");
+	// ========================================================================|
+
+		vhdl << tab << declare("zero_var") << " <= '0';" << endl;
+		LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(2*W+3), "I=>abs_sum;OZB=>zero_var;O=>lzc");
+		syncCycleFromSignal("lzc");
+		setCriticalPath(lzc->getOutputDelay("O"));
+
+		Shifter* normShifter = (Shifter*) newInstance("Shifter", "NormShifter", "wIn=" + to_string(2*W+3) + " maxShift=" + to_string(2*W+3) + " dir=0", "X=>abs_sum;S=>lzc;R=>norm_out");
+		syncCycleFromSignal("norm_out");
+		setCriticalPath(normShifter->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		int wF = 2*W+3;
+		vhdl << tab << declare("normFracRes", wF) << " <= norm_out" << range(wF-1, 0) << ";" << endl;
+
+		addComment("The hidden bit of the larger operand sits one position below the carry");
+		int lzc_size = getSignalByName("lzc")->width();
+		int wSF = max(wE, lzc_size+1) + 1;
+		vhdl << tab << declare("sf_X_ext", wSF) << " <= (" << wSF-1 << " downto " << wE << " => sf_X(sf_X'high)) & sf_X;" << endl;
+		vhdl << tab << declare("lzc_ext", wSF) << " <= " << zg(wSF-lzc_size) << " & lzc;" << endl;
+		vhdl << tab << declare("sf_res", wSF) << " <= sf_X_ext + 1 - lzc_ext;" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+
+		vhdl << tab << declare("z_res") << " <= NOT nzero;" << endl;
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF) + " wF=" + to_string(wF), "Sign=>sign;SF=>sf_res;Frac=>normFracRes;z=>z_res;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+
+	};
+
+
+	void PositFMA::emulate(TestCase * tc) {
+		// get the inputs from the TestCase
+		mpz_class svX = tc->getInputValue ( "InputA" );
+		mpz_class svY = tc->getInputValue ( "InputB" );
+		mpz_class svZ = tc->getInputValue ( "InputC" );
+		// native integers for N <= 64, mpz_class otherwise
+		mpz_class svR = model.fma(svX, svY, svZ);
+		// complete the TestCase with this expected output
+		tc->addExpectedOutput ( "Output", svR );
+	}
+
+
+	OperatorPtr PositFMA::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		return new PositFMA(target, N, es);
+	}
+
+
+	void PositFMA::registerFactory(){
+		UserInterface::add("PositFMA", // name
+											 "A posit fused multiply-add InputA*InputB+InputC, with a single rounding.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int): The input size; \
+                        					 es(int): The exponent size of the Posit;",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "The product of the fractions is kept exact and the addend is aligned to it before a single normalization and rounding.",
+											 PositFMA::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,70 @@
+/*
+  Posit fused multiply-add.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_FMA_HPP
+#define POSIT_FMA_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+
+namespace flopoco {
+
+	/** Computes InputA*InputB+InputC with a single rounding.
+	    The product of the decoded fractions is kept exact, the addend is aligned
+	    to it, and the normalized sum goes through the PositMult packing stages. */
+	class PositFMA : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the inputs.
+		    * @param es The width of the exponent.
+		    */
+		PositFMA(Target* target, int N = 8, int es = 0, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositFMA() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
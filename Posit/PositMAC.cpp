@@ -0,0 +1,396 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "../IntAddSubCmp/IntAdder.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositMAC.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositMAC::PositMAC(Target* target, int N, int es, int wCarry, bool decoded, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), wCarry(wCarry), decoded(decoded), model(N, es), quire(0), quireNaR(false) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositMAC";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositMAC_" << N << "_" << es << "_" << wCarry;
+		if(decoded)
+			name << "_decoded";
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		// the accumulator is a register whatever the target frequency
+		setSequential();
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+		// The scale factor of a nonzero product lies in [-minSF, minSF], minSF = 2(N-2)2^es
+		int minSF = 2*(N-2)*(1<<es);
+		int maxShift = 2*minSF;
+		// Magnitude bits from minpos^2 to maxpos^2, then carries and sign
+		int wMag = maxShift+1;
+		wQ = wMag + wCarry + 1;
+
+
+		/* SET UP THE IO SIGNALS */
+		if(decoded) {
+			// The decoded form of PositDecoder, SF being Reg & Exp
+			addInput  ( "SignA" );
+			addInput  ( "SFA", RegSize+es);
+			addInput  ( "FracA", FracSize);
+			addInput  ( "zA" );
+			addInput  ( "infA" );
+			addInput  ( "SignB" );
+			addInput  ( "SFB", RegSize+es);
+			addInput  ( "FracB", FracSize);
+			addInput  ( "zB" );
+			addInput  ( "infB" );
+		}
+		else {
+			addInput  ( "InputA", N);
+			addInput  ( "InputB", N);
+		}
+		addInput  ( "clear" );
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositMAC \n");
+		REPORT(DETAILED, "this operator has received three parameters " << N << ", " << es << " and " << wCarry);
+		REPORT(DETAILED, "the quire is " << wQ << " bits wide");
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+
+		if(decoded) {
+			// A zero operand has a zero fraction, so z_A and z_B are not needed
+			vhdl << tab << declare("sign_A") << " <= SignA;" << endl;
+			vhdl << tab << declare("sign_B") << " <= SignB;" << endl;
+			vhdl << tab << declare("sf_A", RegSize+es) << " <= SFA;" << endl;
+			vhdl << tab << declare("sf_B", RegSize+es) << " <= SFB;" << endl;
+			vhdl << tab << declare("frac_A", FracSize) << " <= FracA;" << endl;
+			vhdl << tab << declare("frac_B", FracSize) << " <= FracB;" << endl;
+			vhdl << tab << declare("inf_A") << " <= infA;" << endl;
+			vhdl << tab << declare("inf_B") << " <= infB;" << endl;
+		}
+		else {
+			PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+			PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
+			syncCycleFromSignal("reg_A");
+			setCriticalPath(decoderA->getOutputDelay("Reg"));
+			syncCycleFromSignal("reg_B");
+			setCriticalPath(decoderB->getOutputDelay("Reg"));
+
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+
+			addComment("Gather scale factors");
+			vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+			if (es>0) vhdl << " & exp_A";
+			vhdl << ";" << endl;
+			vhdl << tab << declare("sf_B", RegSize+es) << " <= reg_B";
+			if (es>0) vhdl << " & exp_B";
+			vhdl << ";" << endl;
+		}
+
+	//=========================================================================|
+		addFullComment("Sign and Special Cases Computation");
+	// ========================================================================|
+
+		vhdl << tab << declare("sign") << " <= sign_A XOR sign_B;" << endl;
+		vhdl << tab << declare("inf") << " <= inf_A OR inf_B;" << endl;
+
+	//=========================================================================|
+		addFullComment("Multiply the fractions, add the exponent values");
+	// ========================================================================|
+
+		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", "mult", "wX=" + to_string(FracSize) + " wY=" + to_string(FracSize) + " wOut="+ to_string(0), "X=>frac_A;Y=>frac_B;R=>frac_mult");
+		syncCycleFromSignal("frac_mult");
+		setCriticalPath(mult->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		int mult_size = getSignalByName("frac_mult")->width();
+
+		addComment("Offset the scale factor by -minpos^2, a zero product is 0 whatever the shift");
+		int wShiftQ = intlog2(maxShift);
+		vhdl << tab << declare("sf_mult", RegSize+es+2) << " <= (sf_A(sf_A'high) & sf_A(sf_A'high) & sf_A) + (sf_B(sf_B'high) & sf_B(sf_B'high) & sf_B) + " << minSF << ";" << endl;
+		vhdl << tab << declare("shift_q", wShiftQ) << " <= sf_mult" << range(wShiftQ-1, 0) << ";" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(RegSize+es+2));
+
+	//=========================================================================|
+		addFullComment("Place the exact product in the quire");
+	// ========================================================================|
+
+		vhdl << tab << declare("prod_in", mult_size+maxShift) << " <= " << zg(maxShift) << " & frac_mult;" << endl;
+		Shifter* quireShifter = (Shifter*) newInstance("Shifter", "QuireShifter", "wIn=" + to_string(mult_size+maxShift) + " maxShift=" + to_string(maxShift) + " dir=0", "X=>prod_in;S=>shift_q;R=>prod_shifted");
+		syncCycleFromSignal("prod_shifted");
+		setCriticalPath(quireShifter->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("The bits below minpos^2 are always zero");
+		vhdl << tab << declare("prod_mag", wMag) << " <= prod_shifted" << range(wMag+mult_size-3, mult_size-2) << ";" << endl;
+		addComment("One's complement for negative products, the +1 enters as carry in of the accumulator");
+		vhdl << tab << declare("rep_sign", wQ) << " <= (others => sign);" << endl;
+		vhdl << tab << declare("prod_q", wQ) << " <= (" << zg(wQ-wMag) << " & prod_mag) XOR rep_sign;" << endl;
+
+	//=========================================================================|
+		addFullComment("Accumulation - one chunk per adder, carries delayed by one cycle");
+	// ========================================================================|
+
+		int wChunk = wQ;
+		target->suggestSubaddSize(wChunk, wQ);
+		if(wChunk < 1 || wChunk > wQ)
+			wChunk = wQ;
+		int nChunks = (wQ + wChunk - 1) / wChunk;
+		REPORT(DETAILED, "the quire is accumulated in " << nChunks << " chunks of " << wChunk << " bits");
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wChunk));
+
+		for (int c=0; c<nChunks; c++) {
+			int lo = c*wChunk;
+			int w = min(wChunk, wQ-lo);
+			string sc = to_string(c);
+			declare("acc_"+sc, w);
+			declare("carry_"+sc);
+			vhdl << tab << declare("acc_in_"+sc, w) << " <= " << zg(w) << " when clear = '1' else acc_" << sc << ";" << endl;
+			if (c==0)
+				vhdl << tab << declare("cin_"+sc) << " <= sign;" << endl;
+			else
+				vhdl << tab << declare("cin_"+sc) << " <= carry_" << c-1 << " AND NOT clear;" << endl;
+			vhdl << tab << declare("sum_"+sc, w+1) << " <= ('0' & acc_in_" << sc << ") + ('0' & prod_q" << range(lo+w-1, lo) << ") + cin_" << sc << ";" << endl;
+		}
+		declare("nar_acc");
+		vhdl << tab << declare("nar_q") << " <= inf OR (nar_acc AND NOT clear);" << endl;
+
+		vhdl << tab << "process(clk)" << endl;
+		vhdl << tab << "begin" << endl;
+		vhdl << tab << tab << "if clk'event and clk = '1' then" << endl;
+		for (int c=0; c<nChunks; c++) {
+			int w = min(wChunk, wQ-c*wChunk);
+			vhdl << tab << tab << tab << "acc_" << c << " <= sum_" << c << range(w-1, 0) << ";" << endl;
+			vhdl << tab << tab << tab << "carry_" << c << " <= sum_" << c << of(w) << ";" << endl;
+		}
+		vhdl << tab << tab << tab << "nar_acc <= nar_q;" << endl;
+		vhdl << tab << tab << "end if;" << endl;
+		vhdl << tab << "end process;" << endl;
+
+	//=========================================================================|
+		addFullComment("Resolve the delayed carries");
+	// ========================================================================|
+		// The next state of the accumulator, which includes the current product,
+		// is the sum of the chunks and of the carries they produce
+
+		vhdl << tab << declare("quire_acc", wQ) << " <= ";
+		for (int c=nChunks-1; c>=0; c--) {
+			int w = min(wChunk, wQ-c*wChunk);
+			vhdl << "sum_" << c << range(w-1, 0) << (c>0 ? " & " : ";");
+		}
+		vhdl << endl;
+		vhdl << tab << declare("quire_carry", wQ) << " <= ";
+		for (int c=nChunks-1; c>=0; c--) {
+			int w = min(wChunk, wQ-c*wChunk);
+			if (c>0) {
+				int wp = min(wChunk, wQ-(c-1)*wChunk);
+				if (w>1)
+					vhdl << zg(w-1) << " & ";
+				vhdl << "sum_" << c-1 << of(wp) << " & ";
+			}
+			else
+				vhdl << zg(w) << ";";
+		}
+		vhdl << endl;
+		vhdl << tab << declare("zero_cin") << " <= '0';" << endl;
+		IntAdder* quireAdder = (IntAdder*) newInstance("IntAdder", "QuireAdder", "wIn=" + to_string(wQ), "X=>quire_acc;Y=>quire_carry;Cin=>zero_cin;R=>quire");
+		syncCycleFromSignal("quire");
+		setCriticalPath(quireAdder->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		vhdl << tab << declare("quire_sign") << " <= quire(quire'high);" << endl;
+		vhdl << tab << declare("nzero") << " <= '0' when quire = 0 else '1';" << endl;
+		vhdl << tab << declare("rep_quire_sign", wQ-1) << " <= (others => quire_sign);" << endl;
+		vhdl << tab << declare("quire_ones", wQ-1) << " <= quire" << range(wQ-2, 0) << " XOR rep_quire_sign;" << endl;
+		vhdl << tab << declare("zero_abs", wQ-1) << " <= " << zg(wQ-1) << ";" << endl;
+		IntAdder* absAdder = (IntAdder*) newInstance("IntAdder", "AbsAdder", "wIn=" + to_string(wQ-1), "X=>quire_ones;Y=>zero_abs;Cin=>quire_sign;R=>quire_mag");
+		syncCycleFromSignal("quire_mag");
+		setCriticalPath(absAdder->getOutputDelay("R"));
+
+	//=========================================================================|
+		addFullComment("Normalization");
+	// ========================================================================|
+
+		vhdl << tab << declare("zero_var") << " <= '0';" << endl;
+		LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_Component", "wIn=" + to_string(wQ-1), "I=>quire_mag;OZB=>zero_var;O=>lzc");
+		syncCycleFromSignal("lzc");
+		setCriticalPath(lzc->getOutputDelay("O"));
+
+		Shifter* normShifter = (Shifter*) newInstance("Shifter", "NormShifter", "wIn=" + to_string(wQ-1) + " maxShift=" + to_string(wQ-1) + " dir=0", "X=>quire_mag;S=>lzc;R=>norm_out");
+		syncCycleFromSignal("norm_out");
+		setCriticalPath(normShifter->getOutputDelay("R"));
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("Keep the hidden bit and N+1 fraction bits, the rest collapses into a sticky bit");
+		int wF = N+3;
+		vhdl << tab << declare("frac_sticky") << " <= '0' when norm_out" << range(wQ-4-N, 0) << " = 0 else '1';" << endl;
+		vhdl << tab << declare("normFracRes", wF) << " <= norm_out" << range(wQ-2, wQ-3-N) << " & frac_sticky;" << endl;
+
+		addComment("The leading one of the quire sits at position wQ-2-lzc");
+		int lzc_size = getSignalByName("lzc")->width();
+		int maxSF = minSF + wCarry;
+		int wSF = intlog2(max(maxSF, wQ)) + 2;
+		vhdl << tab << declare("lzc_ext", wSF) << " <= " << zg(wSF-lzc_size) << " & lzc;" << endl;
+		vhdl << tab << declare("sf_res", wSF) << " <= \"" << unsignedBinary(mpz_class(maxSF), wSF) << "\" - lzc_ext;" << endl;
+
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF));
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+
+		vhdl << tab << declare("z_res") << " <= NOT nzero;" << endl;
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF) + " wF=" + to_string(wF), "Sign=>quire_sign;SF=>sf_res;Frac=>normFracRes;z=>z_res;inf=>nar_q;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+
+	};
+
+
+	void PositMAC::emulate(TestCase * tc) {
+		// get the inputs from the TestCase
+		mpz_class svC = tc->getInputValue ( "clear" );
+
+		if(svC == 1) {
+			quire = 0;
+			quireNaR = false;
+		}
+		mpz_class p;
+		bool nar;
+		if(decoded) {
+			nar = tc->getInputValue ( "infA" ) == 1 || tc->getInputValue ( "infB" ) == 1;
+			p = tc->getInputValue ( "FracA" ) * tc->getInputValue ( "FracB" );
+			if(!nar && p != 0) {
+				// Frac has its hidden bit at FracSize-1
+				int wSF = RegSize+es;
+				mpz_class sf = tc->getInputValue ( "SFA" ) + tc->getInputValue ( "SFB" );
+				for(string op : {"SFA", "SFB"})
+					if(tc->getInputValue ( op ) >= (mpz_class(1) << (wSF-1)))
+						sf -= mpz_class(1) << wSF;
+				// Near minpos the shift is negative, but then the trailing bits of Frac are zeros
+				long shift = sf.get_si() - 2*(FracSize-1) - model.quireLsb();
+				if(shift >= 0)
+					p <<= shift;
+				else
+					p >>= -shift;
+				if(tc->getInputValue ( "SignA" ) != tc->getInputValue ( "SignB" ))
+					p = -p;
+			}
+		}
+		else
+			nar = !model.quireProduct(tc->getInputValue ( "InputA" ), tc->getInputValue ( "InputB" ), p);
+		if(nar)
+			quireNaR = true;
+		else
+			quire += p;
+
+		// the hardware quire wraps around on overflow
+		mpz_class two_wQ = mpz_class(1) << wQ;
+		quire = quire % two_wQ;
+		if(quire >= (two_wQ >> 1))
+			quire -= two_wQ;
+		else if(quire < -(two_wQ >> 1))
+			quire += two_wQ;
+
+		mpz_class svR = (quireNaR ? mpz_class(1) << (N-1) : model.quireRound(quire));
+		// complete the TestCase with this expected output
+		tc->addExpectedOutput ( "Output", svR );
+	}
+
+
+	TestCase* PositMAC::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		if(decoded) {
+			// Random posits, decoded by the software model
+			const string op[2] = {"A", "B"};
+			for(int j = 0; j < 2; j++) {
+				bool sign, zero, nar;
+				int64_t sf;
+				mpz_class sig;
+				int fbits;
+				model.decodeMpz(getLargeRandom(N), sign, zero, nar, sf, sig, fbits);
+				mpz_class svSF = mpz_class((long) sf);
+				if(svSF < 0)
+					svSF += mpz_class(1) << (RegSize+es);
+				tc->addInput("Sign" + op[j], mpz_class(sign ? 1 : 0));
+				tc->addInput("SF" + op[j], (zero || nar) ? mpz_class(0) : svSF);
+				tc->addInput("Frac" + op[j], (zero || nar) ? mpz_class(0) : mpz_class(sig << (FracSize-1-fbits)));
+				tc->addInput("z" + op[j], mpz_class(zero ? 1 : 0));
+				tc->addInput("inf" + op[j], mpz_class(nar ? 1 : 0));
+			}
+		}
+		else {
+			tc->addInput("InputA", getLargeRandom(N));
+			tc->addInput("InputB", getLargeRandom(N));
+		}
+		tc->addInput("clear", mpz_class(i % 16 == 0 ? 1 : 0));
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositMAC::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int wCarry;
+		UserInterface::parsePositiveInt(args, "wCarry", &wCarry);
+		bool decoded;
+		UserInterface::parseBoolean(args, "decoded", &decoded);
+		return new PositMAC(target, N, es, wCarry, decoded);
+	}
+
+
+	void PositMAC::registerFactory(){
+		UserInterface::add("PositMAC", // name
+											 "A posit multiply-accumulate in a quire, rounded only on output.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult,PositFMA", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int): The input size; \
+                        					 es(int): The exponent size of the Posit; \
+                        					 wCarry(int)=30: The number of carry bits of the quire, 2^wCarry products can be accumulated without overflow; \
+                        					 decoded(bool)=false: take the decoded form of PositDecoder instead of posits;",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "The quire is wide enough to hold any product exactly, so a dot product is rounded only once. With es=2 and wCarry=30 it is 16N bits wide, as in the posit standard.<br> Set clear to 1 with the first product of a new accumulation.",
+											 PositMAC::parseArguments
+											 ) ;
+	}
+
+}//namespace
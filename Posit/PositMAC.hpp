@@ -0,0 +1,91 @@
+/*
+  Posit multiply-accumulate in a quire.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MAC_HPP
+#define POSIT_MAC_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+
+namespace flopoco {
+
+	/** Accumulates the exact products InputA*InputB in a quire, a wide fixed-point
+	    register whose LSB is minpos^2, without any intermediate rounding.
+	    clear starts a new accumulation with the current product. Output is the
+	    quire rounded to a posit, and is NaR if a NaR entered since the last clear.
+	    The quire is split in chunks with delayed carries, so that one product can
+	    be accumulated per cycle at any frequency.
+	    With decoded=true the operands are outputs of PositDecoder, so that an
+	    operand decoded once can feed several accumulators, as in PositMatMul. */
+	class PositMAC : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** Number of carry bits above maxpos^2 in the quire */
+		int wCarry;
+		/** Inputs in the decoded form of PositDecoder, SF being Reg & Exp */
+		bool decoded;
+
+		int RegSize;
+		int FracSize;
+		/** Width of the quire */
+		int wQ;
+
+		/** Software model used by emulate */
+		PositModel model;
+		/** Software quire and NaR flag, updated by emulate in test order */
+		mpz_class quire;
+		bool quireNaR;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the inputs.
+		    * @param es The width of the exponent.
+		    * @param wCarry The number of carry bits: 2^wCarry products can be accumulated without overflow.
+		    * @param decoded Take the decoded form of PositDecoder instead of posits.
+		    */
+		PositMAC(Target* target, int N = 8, int es = 0, int wCarry = 30, bool decoded = false, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositMAC() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator.
+		   It has a state: test cases must be emulated in order */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   The quire is cleared every 16 test cases */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,193 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "PositDecoder.hpp"
+#include "PositMAC.hpp"
+
+// include the header of the Operator
+#include "PositMatMul.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositMatMul::PositMatMul(Target* target, int N, int es, int R, int C, int wCarry, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), R(R), C(C), wCarry(wCarry), model(N, es), quire(R*C, 0), quireNaR(R*C, false) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositMatMul";
+
+		if(R < 1 || C < 1)
+			THROWERROR("the array needs at least one row and one column, got R=" << R << " C=" << C);
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositMatMul_" << N << "_" << es << "_" << R << "x" << C << "_" << wCarry;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		// the operands move by one element per cycle whatever the target frequency
+		setSequential();
+
+		RegSize = intlog2(N-1)+1;
+		// as in PositMAC
+		int minSF = 2*(N-2)*(1<<es);
+		wQ = 2*minSF + 1 + wCarry + 1;
+
+		/* SET UP THE IO SIGNALS */
+		for (int i=0; i<R; i++)
+			addInput  ( "A_" + to_string(i), N);
+		for (int j=0; j<C; j++)
+			addInput  ( "B_" + to_string(j), N);
+		addInput  ( "clear" );
+		for (int i=0; i<R; i++)
+			for (int j=0; j<C; j++)
+				addOutput ( "Output_" + to_string(i) + "_" + to_string(j), N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositMatMul \n");
+		REPORT(DETAILED, "this operator has received five parameters " << N << ", " << es << ", " << R << ", " << C << " and " << wCarry);
+
+	//=========================================================================|
+		addFullComment("Data Extraction at the edge of the array");
+	// ========================================================================|
+
+		double cpIn = getCriticalPath();
+		int cycleDec = 0;
+		double cpDec = 0;
+		for (int k=0; k<R+C; k++) {
+			string s = (k < R ? "A_" + to_string(k) : "B_" + to_string(k-R));
+			setCycle(0);
+			setCriticalPath(cpIn);
+			PositDecoder* decoder = (PositDecoder*) newInstance("PositDecoder", "decoder" + s, "N=" + to_string(N) + " es=" + to_string(es), "Input=>" + s + ";Sign=>sign_" + s + ";Reg=>reg_" + s + ";Exp=>exp_" + s + ";Frac=>frac_" + s + ";z=>z_" + s + ";inf=>inf_" + s);
+			syncCycleFromSignal("reg_" + s);
+			setCriticalPath(decoder->getOutputDelay("Reg"));
+			vhdl << tab << declare("sf_" + s, RegSize+es) << " <= reg_" << s;
+			if (es>0) vhdl << " & exp_" << s;
+			vhdl << ";" << endl;
+			if(getCurrentCycle() > cycleDec || (getCurrentCycle() == cycleDec && getCriticalPath() > cpDec)) {
+				cycleDec = getCurrentCycle();
+				cpDec = getCriticalPath();
+			}
+		}
+
+	//=========================================================================|
+		addFullComment("Processing elements");
+	// ========================================================================|
+		// Element (i,j) works i+j cycles after the decoders: the delay lines of the
+		// decoded operands are the registers between neighbouring elements
+		for (int i=0; i<R; i++) {
+			for (int j=0; j<C; j++) {
+				string a = "A_" + to_string(i);
+				string b = "B_" + to_string(j);
+				string ij = to_string(i) + "_" + to_string(j);
+				setCycle(cycleDec + i + j);
+				setCriticalPath(i+j == 0 ? cpDec : 0);
+				newInstance("PositMAC", "pe_" + ij, "N=" + to_string(N) + " es=" + to_string(es) + " wCarry=" + to_string(wCarry) + " decoded=true",
+								"SignA=>sign_" + a + ";SFA=>sf_" + a + ";FracA=>frac_" + a + ";zA=>z_" + a + ";infA=>inf_" + a +
+								";SignB=>sign_" + b + ";SFB=>sf_" + b + ";FracB=>frac_" + b + ";zB=>z_" + b + ";infB=>inf_" + b +
+								";clear=>clear;Output=>pe_out_" + ij);
+			}
+		}
+
+		addComment("Undo the skew of the array");
+		for (int i=0; i<R; i++)
+			for (int j=0; j<C; j++)
+				syncCycleFromSignal("pe_out_" + to_string(i) + "_" + to_string(j));
+		for (int i=0; i<R; i++)
+			for (int j=0; j<C; j++)
+				vhdl << tab << "Output_" << i << "_" << j << " <= pe_out_" << i << "_" << j << ";" << endl;
+	};
+
+
+	void PositMatMul::emulate(TestCase * tc) {
+		bool clear = (tc->getInputValue ( "clear" ) == 1);
+		mpz_class two_wQ = mpz_class(1) << wQ;
+		for (int i=0; i<R; i++) {
+			mpz_class svA = tc->getInputValue ( "A_" + to_string(i) );
+			for (int j=0; j<C; j++) {
+				int k = i*C + j;
+				if(clear) {
+					quire[k] = 0;
+					quireNaR[k] = false;
+				}
+				mpz_class p;
+				if(model.quireProduct(svA, tc->getInputValue ( "B_" + to_string(j) ), p))
+					quire[k] += p;
+				else
+					quireNaR[k] = true;
+
+				// the hardware quire wraps around on overflow
+				quire[k] = quire[k] % two_wQ;
+				if(quire[k] >= (two_wQ >> 1))
+					quire[k] -= two_wQ;
+				else if(quire[k] < -(two_wQ >> 1))
+					quire[k] += two_wQ;
+
+				mpz_class svR = (quireNaR[k] ? mpz_class(1) << (N-1) : model.quireRound(quire[k]));
+				tc->addExpectedOutput ( "Output_" + to_string(i) + "_" + to_string(j), svR );
+			}
+		}
+	}
+
+
+	TestCase* PositMatMul::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		for (int k=0; k<R; k++)
+			tc->addInput("A_" + to_string(k), getLargeRandom(N));
+		for (int k=0; k<C; k++)
+			tc->addInput("B_" + to_string(k), getLargeRandom(N));
+		tc->addInput("clear", mpz_class(i % 16 == 0 ? 1 : 0));
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositMatMul::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int R;
+		UserInterface::parseStrictlyPositiveInt(args, "R", &R);
+		int C;
+		UserInterface::parseStrictlyPositiveInt(args, "C", &C);
+		int wCarry;
+		UserInterface::parsePositiveInt(args, "wCarry", &wCarry);
+		return new PositMatMul(target, N, es, R, C, wCarry);
+	}
+
+
+	void PositMatMul::registerFactory(){
+		UserInterface::add("PositMatMul", // name
+											 "A systolic array of posit multiply-accumulates for matrix products.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMAC,PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size; \
+                        					 R(int)=4: The number of rows of the array; \
+                        					 C(int)=4: The number of columns of the array; \
+                        					 wCarry(int)=30: The number of carry bits of each quire",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Each cycle, input a column of A (A_i) and a row of B (B_j); Output_i_j accumulates A_i*B_j. Set clear to 1 with the first column and row of a new product.",
+											 PositMatMul::parseArguments
+											 ) ;
+	}
+
+}//namespace
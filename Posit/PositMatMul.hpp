@@ -0,0 +1,95 @@
+/*
+  Systolic array of posit multiply-accumulates.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MAT_MUL_HPP
+#define POSIT_MAT_MUL_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** An R x C output-stationary systolic array for posit matrix products.
+	    Each cycle takes a column A_0..A_{R-1} of the left matrix and a row
+	    B_0..B_{C-1} of the right one, and processing element (i,j) accumulates
+	    A_i*B_j in its quire, as PositMAC does: after K cycles, Output_i_j is
+	    the rounded (i,j) entry of the product of an R x K and a K x C matrix.
+	    The operands are decoded once, at the edge of the array, and the
+	    decoded values move one element to the right (A) or down (B) per cycle.
+	    The skew of the array is internal, and the outputs are aligned. */
+	class PositMatMul : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** Rows and columns of the array */
+		int R;
+		int C;
+		/** Number of carry bits above maxpos^2 in the quires */
+		int wCarry;
+
+		int RegSize;
+		/** Width of the quires */
+		int wQ;
+
+		/** Software model used by emulate */
+		PositModel model;
+		/** Software quires and NaR flags, row by row, updated by emulate in test order */
+		vector<mpz_class> quire;
+		vector<bool> quireNaR;
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param R The number of rows of the array.
+		    * @param C The number of columns of the array.
+		    * @param wCarry The number of carry bits of each quire.
+		    */
+		PositMatMul(Target* target, int N = 8, int es = 0, int R = 4, int C = 4, int wCarry = 30, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositMatMul() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator.
+		   It has a state: test cases must be emulated in order */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   The quires are cleared every 16 test cases */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
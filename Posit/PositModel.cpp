@@ -0,0 +1,585 @@
+/* Software reference model for posit arithmetic.
+   Formats up to 64 bits are handled with native integers only, so that the
+   emulate function of the posit operators does not allocate per test case */
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "PositModel.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	typedef unsigned __int128 uint128_t;
+
+
+	PositModel::PositModel(int N, int es) :
+	N(N), es(es) {
+		mask = (N>=64 ? ~((uint64_t)0) : (((uint64_t)1)<<N)-1);
+		narBits = (N>64 ? 0 : ((uint64_t)1)<<(N-1));
+	}
+
+
+	void PositModel::decode(uint64_t x, PositValue& v) const {
+		x &= mask;
+		v.sticky = false;
+		v.zero = (x == 0);
+		v.nar = (x == narBits);
+		v.sign = (x >> (N-1)) & 1;
+		if(v.zero || v.nar) {
+			v.sf = 0;
+			v.sig = 0;
+			return;
+		}
+		if(v.sign)
+			x = (-x) & mask;
+
+		// Left-align the N-1 bits following the sign
+		uint64_t y = x << (64-(N-1));
+		int rc = y >> 63;
+		// The shifted-in zeros bound the run of ones to N-1 bits
+		int run = (rc ? __builtin_clzll(~y) : __builtin_clzll(y));
+		int64_t k = (rc ? run-1 : -run);
+		int consumed = (run+1 > N-1 ? N-1 : run+1);
+		uint64_t rest = y << consumed;
+
+		uint64_t e = 0;
+		if(es > 0) {
+			e = rest >> (64-es);
+			rest = rest << es;
+		}
+		v.sf = k * (((int64_t)1) << es) + (int64_t)e;
+		v.sig = (((uint64_t)1) << 63) | (rest >> 1);
+	}
+
+
+	uint64_t PositModel::encode(const PositValue& v, PositRounding* rounding) const {
+		if(rounding)
+			*rounding = PositRounding{false, false, false, false, false};
+		if(v.nar)
+			return narBits;
+		if(v.zero)
+			return 0;
+
+		int64_t k = v.sf >> es; // floor division
+		uint64_t p;
+		if(k > N-2) {
+			p = maxpos();
+			if(rounding)
+				rounding->saturated = true;
+		}
+		else if(k < -(N-2)) {
+			p = minpos();
+			if(rounding)
+				rounding->saturated = true;
+		}
+		else {
+			// Stream regime, exponent and fraction into a window of N-1 bits plus the round bit
+			const int W = N;
+			uint128_t acc = 0;
+			int len = 0;
+			bool sticky = v.sticky;
+			uint64_t fields[3];
+			int sizes[3];
+			if(k >= 0) {
+				sizes[0] = k+2;
+				fields[0] = ((((uint64_t)1) << (k+1)) - 1) << 1;
+			}
+			else {
+				sizes[0] = -k+1;
+				fields[0] = 1;
+			}
+			sizes[1] = es;
+			fields[1] = (uint64_t)(v.sf - k * (((int64_t)1) << es));
+			sizes[2] = 63;
+			fields[2] = v.sig & ((((uint64_t)1) << 63) - 1);
+
+			for(int i=0; i<3; i++) {
+				int n = sizes[i];
+				if(n == 0)
+					continue;
+				int room = W - len;
+				if(room >= n) {
+					acc = (acc << n) | fields[i];
+					len += n;
+				}
+				else {
+					int drop = n - room;
+					acc = (acc << room) | (fields[i] >> drop);
+					sticky = sticky || ((fields[i] & ((((uint64_t)1) << drop) - 1)) != 0);
+					len = W;
+				}
+			}
+			acc <<= (W - len);
+
+			p = (uint64_t)(acc >> 1);
+			bool round = acc & 1;
+			if(rounding)
+				*rounding = PositRounding{false, es > 0 && sizes[0]+es > N-1, (p & 1) != 0, round, sticky};
+			if(round && (sticky || (p & 1)))
+				p++;
+		}
+		return (v.sign ? (-p) & mask : p);
+	}
+
+
+	void PositModel::multExact(const PositValue& a, const PositValue& b, PositValue& r) const {
+		r.sign = a.sign ^ b.sign;
+		r.nar = a.nar || b.nar;
+		r.zero = !r.nar && (a.zero || b.zero);
+		if(r.nar || r.zero) {
+			r.sf = 0;
+			r.sig = 0;
+			r.sticky = false;
+			return;
+		}
+		// Both significands are in [1,2) so the product is in [1,4)
+		uint128_t prod = (uint128_t)a.sig * (uint128_t)b.sig;
+		if(prod >> 127) {
+			r.sf = a.sf + b.sf + 1;
+			r.sig = (uint64_t)(prod >> 64);
+			r.sticky = ((uint64_t)prod != 0);
+		}
+		else {
+			r.sf = a.sf + b.sf;
+			r.sig = (uint64_t)(prod >> 63);
+			r.sticky = (((uint64_t)prod & ((((uint64_t)1) << 63) - 1)) != 0);
+		}
+		r.sticky = r.sticky || a.sticky || b.sticky;
+	}
+
+
+	uint64_t PositModel::mult(uint64_t a, uint64_t b) const {
+		PositValue va, vb, vr;
+		decode(a, va);
+		decode(b, vb);
+		multExact(va, vb, vr);
+		return encode(vr);
+	}
+
+
+	mpz_class PositModel::mult(const mpz_class& a, const mpz_class& b) const {
+		if(N <= 64) {
+			uint64_t r = mult((uint64_t)mpz_get_ui(a.get_mpz_t()), (uint64_t)mpz_get_ui(b.get_mpz_t()));
+			return mpz_class((unsigned long)r);
+		}
+
+		bool signA, zeroA, narA, signB, zeroB, narB;
+		int64_t sfA, sfB;
+		mpz_class sigA, sigB;
+		int fbitsA, fbitsB;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		if(narA || narB)
+			return mpz_class(1) << (N-1);
+		if(zeroA || zeroB)
+			return mpz_class(0);
+
+		mpz_class sig = sigA * sigB;
+		int fbits = fbitsA + fbitsB;
+		int64_t sf = sfA + sfB;
+		if(mpz_tstbit(sig.get_mpz_t(), fbits+1)) {
+			fbits++;
+			sf++;
+		}
+		return encodeMpz(signA != signB, sf, sig, fbits, false);
+	}
+
+
+	mpz_class PositModel::add(const mpz_class& a, const mpz_class& b) const {
+		bool signA, zeroA, narA, signB, zeroB, narB;
+		int64_t sfA, sfB;
+		mpz_class sigA, sigB;
+		int fbitsA, fbitsB;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		if(narA || narB)
+			return mpz_class(1) << (N-1);
+		if(zeroA)
+			sigA = 0;
+		if(zeroB)
+			sigB = 0;
+
+		// Both significands as integers on the weight of the smaller LSB
+		int64_t eA = sfA - fbitsA;
+		int64_t eB = sfB - fbitsB;
+		int64_t e = (eA < eB ? eA : eB);
+		mpz_class x = (sigA << (eA - e)) * (signA ? -1 : 1) + (sigB << (eB - e)) * (signB ? -1 : 1);
+		return encodeExactMpz(x, e);
+	}
+
+
+	mpz_class PositModel::div(const mpz_class& a, const mpz_class& b) const {
+		bool signA, zeroA, narA, signB, zeroB, narB;
+		int64_t sfA, sfB;
+		mpz_class sigA, sigB;
+		int fbitsA, fbitsB;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		if(narA || narB || zeroB)
+			return mpz_class(1) << (N-1);
+		if(zeroA)
+			return mpz_class(0);
+
+		// N+2 quotient bits below the hidden bit are more than the rounding needs
+		int fbits = fbitsA + N + 2;
+		mpz_class num = sigA << (fbitsB + N + 2);
+		mpz_class q = num / sigB;
+		bool sticky = (q * sigB != num);
+		int64_t sf = sfA - sfB;
+		if(!mpz_tstbit(q.get_mpz_t(), fbits)) {
+			fbits--;
+			sf--;
+		}
+		return encodeMpz(signA != signB, sf, q, fbits, sticky);
+	}
+
+
+	mpz_class PositModel::sqrt(const mpz_class& a) const {
+		bool sign, zero, nar;
+		int64_t sf;
+		mpz_class sig;
+		int fbits;
+		decodeMpz(a, sign, zero, nar, sf, sig, fbits);
+		if(nar || sign)
+			return mpz_class(1) << (N-1);
+		if(zero)
+			return mpz_class(0);
+
+		// An even scale factor, the significand in [1,4)
+		if(sf & 1) {
+			sig <<= 1;
+			sf--;
+		}
+		int rbits = N + 2;
+		mpz_class rad = sig << (2*rbits - fbits);
+		mpz_class root, rem;
+		mpz_sqrtrem(root.get_mpz_t(), rem.get_mpz_t(), rad.get_mpz_t());
+		return encodeMpz(false, sf / 2, root, rbits, rem != 0);
+	}
+
+
+	void PositModel::multBracket(const mpz_class& a, const mpz_class& b, mpz_class& lo, mpz_class& hi) const {
+		mpz_class r = mult(a, b);
+		bool signA, zeroA, narA, signB, zeroB, narB, signR, zeroR, narR;
+		int64_t sfA, sfB, sfR;
+		mpz_class sigA, sigB, sigR;
+		int fbitsA, fbitsB, fbitsR;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		decodeMpz(r, signR, zeroR, narR, sfR, sigR, fbitsR);
+		// lo and hi may be a or b: they are only written once both are decoded
+		lo = r;
+		hi = r;
+		if(zeroR || narR)
+			return;
+
+		// Compare the magnitudes of the exact product and of r, as integers scaled to the same LSB
+		mpz_class sig = sigA * sigB;
+		int64_t lsb = sfA + sfB - fbitsA - fbitsB;
+		int64_t lsbR = sfR - fbitsR;
+		if(lsb < lsbR)
+			sigR <<= lsbR - lsb;
+		else
+			sig <<= lsb - lsbR;
+		int c = cmp(sig, sigR);
+		if(c == 0)
+			return;
+
+		// Posits are ordered as two's complement integers: the other neighbour is r+1 or r-1
+		mpz_class modulus = mpz_class(1) << N;
+		bool above = (c > 0) != signR;
+		mpz_class other = (above ? mpz_class(r + 1) : mpz_class(r + modulus - 1)) % modulus;
+		if(other == 0 || other == (mpz_class(1) << (N-1)))
+			return; // saturated to minpos or maxpos
+		if(above)
+			hi = other;
+		else
+			lo = other;
+	}
+
+
+	uint64_t PositModel::fma(uint64_t a, uint64_t b, uint64_t c) const {
+		PositValue va, vb, vc;
+		decode(a, va);
+		decode(b, vb);
+		decode(c, vc);
+		if(va.nar || vb.nar || vc.nar)
+			return narBits;
+		if(va.zero || vb.zero)
+			return c & mask;
+		if(vc.zero)
+			return mult(a, b);
+
+		// Both addends as sig*2^(sf-122), with sig < 2^124 so that the sum cannot overflow.
+		// At most 61 fraction bits are significant in a posit64, so the right shift of the product is exact.
+		bool signP = va.sign ^ vb.sign;
+		int64_t sfP = va.sf + vb.sf;
+		uint128_t sigP = ((uint128_t)va.sig * (uint128_t)vb.sig) >> 4;
+		uint128_t sigC = ((uint128_t)vc.sig) << 59;
+
+		bool signX, signY;
+		int64_t sfX, d;
+		uint128_t sigX, sigY;
+		if(sfP >= vc.sf) {
+			signX = signP; sfX = sfP; sigX = sigP;
+			signY = vc.sign; sigY = sigC;
+			d = sfP - vc.sf;
+		}
+		else {
+			signX = vc.sign; sfX = vc.sf; sigX = sigC;
+			signY = signP; sigY = sigP;
+			d = vc.sf - sfP;
+		}
+		// Align, jamming the shifted-out bits in the last position: it is far below the rounding point
+		if(d > 0) {
+			if(d >= 126)
+				sigY = 1;
+			else
+				sigY = (sigY >> d) | (((sigY & ((((uint128_t)1) << d) - 1)) != 0) ? 1 : 0);
+		}
+
+		PositValue r;
+		r.nar = false;
+		r.zero = false;
+		r.sticky = false;
+		uint128_t sum;
+		if(signX == signY) {
+			sum = sigX + sigY;
+			r.sign = signX;
+		}
+		else if(sigX >= sigY) {
+			sum = sigX - sigY;
+			r.sign = signX;
+		}
+		else {
+			sum = sigY - sigX;
+			r.sign = signY;
+		}
+		if(sum == 0)
+			return 0;
+
+		// Normalize to a hidden bit at position 63
+		uint64_t hi = (uint64_t)(sum >> 64);
+		int msb = (hi ? 127 - __builtin_clzll(hi) : 63 - __builtin_clzll((uint64_t)sum));
+		r.sf = sfX + (msb - 122);
+		if(msb >= 63) {
+			r.sig = (uint64_t)(sum >> (msb-63));
+			r.sticky = (msb > 63) && ((sum & ((((uint128_t)1) << (msb-63)) - 1)) != 0);
+		}
+		else {
+			r.sig = ((uint64_t)sum) << (63-msb);
+		}
+		return encode(r);
+	}
+
+
+	mpz_class PositModel::fma(const mpz_class& a, const mpz_class& b, const mpz_class& c) const {
+		if(N <= 64) {
+			uint64_t r = fma((uint64_t)mpz_get_ui(a.get_mpz_t()), (uint64_t)mpz_get_ui(b.get_mpz_t()), (uint64_t)mpz_get_ui(c.get_mpz_t()));
+			return mpz_class((unsigned long)r);
+		}
+
+		bool signA, zeroA, narA, signB, zeroB, narB, signC, zeroC, narC;
+		int64_t sfA, sfB, sfC;
+		mpz_class sigA, sigB, sigC;
+		int fbitsA, fbitsB, fbitsC;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		decodeMpz(c, signC, zeroC, narC, sfC, sigC, fbitsC);
+		if(narA || narB || narC)
+			return mpz_class(1) << (N-1);
+
+		// Exact sum of sigP*2^eP and sigC*2^eC
+		mpz_class sigP = (zeroA || zeroB ? mpz_class(0) : sigA * sigB);
+		int64_t eP = sfA + sfB - fbitsA - fbitsB;
+		if(zeroC)
+			sigC = 0;
+		int64_t eC = sfC - fbitsC;
+		if(signA != signB)
+			sigP = -sigP;
+		if(signC)
+			sigC = -sigC;
+		int64_t e = (eP < eC ? eP : eC);
+		mpz_class x = (sigP << (eP - e)) + (sigC << (eC - e));
+		return encodeExactMpz(x, e);
+	}
+
+
+	mpz_class PositModel::encodeExactMpz(const mpz_class& x, int64_t e) const {
+		if(x == 0)
+			return mpz_class(0);
+		bool sign = (x < 0);
+		mpz_class m = abs(x);
+		int fbits = mpz_sizeinbase(m.get_mpz_t(), 2) - 1;
+		return encodeMpz(sign, e + fbits, m, fbits, false);
+	}
+
+
+	bool PositModel::quireProduct(const mpz_class& a, const mpz_class& b, mpz_class& p) const {
+		bool signA, zeroA, narA, signB, zeroB, narB;
+		int64_t sfA, sfB;
+		mpz_class sigA, sigB;
+		int fbitsA, fbitsB;
+		decodeMpz(a, signA, zeroA, narA, sfA, sigA, fbitsA);
+		decodeMpz(b, signB, zeroB, narB, sfB, sigB, fbitsB);
+		if(narA || narB)
+			return false;
+		if(zeroA || zeroB) {
+			p = 0;
+			return true;
+		}
+		// Every posit is a multiple of minpos, so the shift is never negative
+		p = (sigA * sigB) << (sfA + sfB - fbitsA - fbitsB - quireLsb());
+		if(signA != signB)
+			p = -p;
+		return true;
+	}
+
+
+	mpz_class PositModel::quireRound(const mpz_class& q) const {
+		return encodeExactMpz(q, quireLsb());
+	}
+
+
+	void PositModel::decodeMpz(const mpz_class& xIn, bool& sign, bool& zero, bool& nar, int64_t& sf, mpz_class& sig, int& fbits) const {
+		mpz_class two_N = mpz_class(1) << N;
+		mpz_class x = xIn % two_N;
+		zero = (x == 0);
+		nar = (x == (mpz_class(1) << (N-1)));
+		sign = mpz_tstbit(x.get_mpz_t(), N-1);
+		sf = 0;
+		sig = 0;
+		fbits = 0;
+		if(zero || nar)
+			return;
+		if(sign)
+			x = two_N - x;
+
+		int rc = mpz_tstbit(x.get_mpz_t(), N-2);
+		int run = 0;
+		while(run < N-1 && (int)mpz_tstbit(x.get_mpz_t(), N-2-run) == rc)
+			run++;
+		int64_t k = (rc ? run-1 : -run);
+		int consumed = (run+1 > N-1 ? N-1 : run+1);
+		int m = N-1-consumed; // remaining bits
+		mpz_class rest = x & ((mpz_class(1) << m) - 1);
+
+		mpz_class e;
+		if(m >= es) {
+			fbits = m-es;
+			e = rest >> fbits;
+			sig = (mpz_class(1) << fbits) | (rest & ((mpz_class(1) << fbits) - 1));
+		}
+		else {
+			fbits = 0;
+			e = rest << (es-m);
+			sig = 1;
+		}
+		sf = k * (((int64_t)1) << es) + (int64_t)mpz_get_ui(e.get_mpz_t());
+	}
+
+
+	mpz_class PositModel::encodeMpz(bool sign, int64_t sf, const mpz_class& sig, int fbits, bool sticky) const {
+		int64_t k = sf >> es;
+		mpz_class p;
+		if(k > N-2) {
+			p = (mpz_class(1) << (N-1)) - 1;
+		}
+		else if(k < -(N-2)) {
+			p = 1;
+		}
+		else {
+			mpz_class str;
+			int len;
+			if(k >= 0) {
+				str = ((mpz_class(1) << (k+1)) - 1) << 1;
+				len = k+2;
+			}
+			else {
+				str = 1;
+				len = -k+1;
+			}
+			str = (str << es) | mpz_class((unsigned long)(sf - k * (((int64_t)1) << es)));
+			len += es;
+			str = (str << fbits) | (sig - (mpz_class(1) << fbits));
+			len += fbits;
+
+			if(len > N) {
+				int drop = len - N;
+				sticky = sticky || ((str & ((mpz_class(1) << drop) - 1)) != 0);
+				str >>= drop;
+			}
+			else {
+				str <<= (N - len);
+			}
+			p = str >> 1;
+			bool round = mpz_tstbit(str.get_mpz_t(), 0);
+			if(round && (sticky || mpz_tstbit(p.get_mpz_t(), 0)))
+				p++;
+		}
+		if(sign && p != 0)
+			p = (mpz_class(1) << N) - p;
+		return p;
+	}
+
+
+	mpz_class PositModel::toIEEE(const mpz_class& x, int wE, int wF) const {
+		bool sign, zero, nar;
+		int64_t sf;
+		mpz_class sig;
+		int fbits;
+		decodeMpz(x, sign, zero, nar, sf, sig, fbits);
+		mpz_class expOnes = (mpz_class(1) << wE) - 1;
+		if(nar)
+			return ((expOnes << 1) | 1) << (wF-1);
+		if(zero)
+			return mpz_class(0);
+
+		// Quantum of the result: 2^(sf-wF) for a normal, 2^(emin-wF) for a subnormal
+		int64_t bias = (((int64_t)1) << (wE-1)) - 1;
+		int64_t emin = 1 - bias;
+		int64_t q = (sf > emin ? sf : emin) - wF;
+		int64_t d = sf - fbits - q;
+		mpz_class m;
+		if(d >= 0)
+			m = sig << d;
+		else {
+			m = sig >> -d;
+			mpz_class rest = sig - (m << -d);
+			mpz_class half = mpz_class(1) << (-d-1);
+			if(rest > half || (rest == half && mpz_tstbit(m.get_mpz_t(), 0)))
+				m++;
+		}
+		// m includes the hidden bit of a normal: it carries into the exponent field,
+		// and so does a rounding overflow of the significand
+		mpz_class r = m;
+		if(sf >= emin)
+			r += mpz_class(sf + bias - 1) << wF;
+		if(r >= (expOnes << wF))
+			r = expOnes << wF;
+		if(sign)
+			r |= mpz_class(1) << (wE+wF);
+		return r;
+	}
+
+
+	mpz_class PositModel::fromIEEE(const mpz_class& f, int wE, int wF) const {
+		bool sign = mpz_tstbit(f.get_mpz_t(), wE+wF);
+		mpz_class E = (f >> wF) & ((mpz_class(1) << wE) - 1);
+		mpz_class F = f & ((mpz_class(1) << wF) - 1);
+		if(E == (mpz_class(1) << wE) - 1)
+			return mpz_class(1) << (N-1);
+		if(E == 0 && F == 0)
+			return mpz_class(0);
+		int64_t bias = (((int64_t)1) << (wE-1)) - 1;
+		if(E != 0)
+			return encodeMpz(sign, (int64_t)mpz_get_ui(E.get_mpz_t()) - bias, (mpz_class(1) << wF) | F, wF, false);
+		// subnormal: F*2^(1-bias-wF), normalised on its leading one
+		int fbits = mpz_sizeinbase(F.get_mpz_t(), 2) - 1;
+		return encodeMpz(sign, 1 - bias - wF + fbits, F, fbits, false);
+	}
+
+}//namespace
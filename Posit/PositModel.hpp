@@ -0,0 +1,148 @@
+/*
+  Software reference model for posit arithmetic.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MODEL_HPP
+#define POSIT_MODEL_HPP
+
+#include <stdint.h>
+#include <gmp.h>
+#include <gmpxx.h>
+
+
+namespace flopoco {
+
+	/** Decoded (unpacked) posit value.
+	    The significand is left-aligned on 64 bits: the hidden bit is bit 63 and
+	    the fraction follows. Bits lost beyond the last one are ORed into sticky. */
+	struct PositValue {
+		bool sign;
+		bool zero;
+		bool nar;
+		/** The scale factor, k*2^es + e */
+		int64_t sf;
+		/** The significand 1.f, hidden bit at position 63 */
+		uint64_t sig;
+		/** 1 if some nonzero bits were dropped below sig */
+		bool sticky;
+	};
+
+
+	/** How encode rounded a value, for test coverage */
+	struct PositRounding {
+		/** Beyond maxpos or below minpos: the result is maxpos or minpos */
+		bool saturated;
+		/** Some bits of the exponent did not fit */
+		bool expTruncated;
+		/** The last bit kept, the first bit dropped, and the OR of the others */
+		bool lsb;
+		bool guard;
+		bool sticky;
+	};
+
+
+	/** Bit-exact software model of posit<N,es> arithmetic.
+	    For N <= 64 every operation works on native 64/128-bit integers and never
+	    allocates; wider formats fall back to mpz_class.
+	    Rounding is round-to-nearest-even on the posit bit string, with saturation
+	    to minpos/maxpos (a nonzero result never rounds to zero nor to NaR). */
+	class PositModel {
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    */
+		PositModel(int N, int es);
+
+		/** Incremented whenever a result of the model changes, so that the product
+		    tables cached on disk by PositMultTable are built again */
+		static const uint32_t version = 1;
+
+		/** Unpack an N-bit posit, N <= 64 */
+		void decode(uint64_t x, PositValue& v) const;
+
+		/** Round and pack a value into an N-bit posit, N <= 64.
+		    rounding, when not NULL, tells how v was rounded */
+		uint64_t encode(const PositValue& v, PositRounding* rounding = NULL) const;
+
+		/** Posit product, N <= 64 */
+		uint64_t mult(uint64_t a, uint64_t b) const;
+
+		/** Posit product for any N */
+		mpz_class mult(const mpz_class& a, const mpz_class& b) const;
+
+		/** The posits lo <= hi bracketing the exact product a*b, for any N: the faithful results.
+		    lo == hi when the product is a posit, or when it saturates */
+		void multBracket(const mpz_class& a, const mpz_class& b, mpz_class& lo, mpz_class& hi) const;
+
+		/** Exact product of two decoded values, before rounding */
+		void multExact(const PositValue& a, const PositValue& b, PositValue& r) const;
+
+		/** Fused multiply-add a*b+c with a single rounding, N <= 64 */
+		uint64_t fma(uint64_t a, uint64_t b, uint64_t c) const;
+
+		/** Fused multiply-add a*b+c with a single rounding, for any N */
+		mpz_class fma(const mpz_class& a, const mpz_class& b, const mpz_class& c) const;
+
+		/** Posit sum a+b for any N */
+		mpz_class add(const mpz_class& a, const mpz_class& b) const;
+
+		/** Posit quotient a/b for any N, NaR when b is zero */
+		mpz_class div(const mpz_class& a, const mpz_class& b) const;
+
+		/** Posit square root for any N, NaR for a negative input */
+		mpz_class sqrt(const mpz_class& a) const;
+
+		/** Weight of the LSB of the quire, minpos^2 = 2^quireLsb() */
+		int64_t quireLsb() const {return -2*((int64_t)(N-2) << es);}
+
+		/** Exact product a*b as a signed multiple of minpos^2, false if it is NaR */
+		bool quireProduct(const mpz_class& a, const mpz_class& b, mpz_class& p) const;
+
+		/** Round a quire, a signed multiple of minpos^2, to a posit */
+		mpz_class quireRound(const mpz_class& q) const;
+
+		/** The bit patterns of the special values */
+		uint64_t zero() const {return 0;}
+		uint64_t nar() const {return narBits;}
+		uint64_t maxpos() const {return narBits-1;}
+		uint64_t minpos() const {return 1;}
+
+		/** true if the native (allocation-free) path is used */
+		bool isNative() const {return N<=64;}
+
+		/** Decode an N-bit posit held in a mpz_class, for any N.
+		    The significand is returned with the hidden bit at position fbits. */
+		void decodeMpz(const mpz_class& x, bool& sign, bool& zero, bool& nar, int64_t& sf, mpz_class& sig, int& fbits) const;
+		/** Round and pack a significand with the hidden bit at position fbits, for any N */
+		mpz_class encodeMpz(bool sign, int64_t sf, const mpz_class& sig, int fbits, bool sticky) const;
+		/** Round and pack the exact value x*2^e, x a signed integer, for any N */
+		mpz_class encodeExactMpz(const mpz_class& x, int64_t e) const;
+
+		/** Convert a posit to an IEEE-754 format with wE exponent and wF fraction bits,
+		    rounding to nearest even, with subnormals and overflow to infinity.
+		    NaR becomes the quiet NaN with a zero sign */
+		mpz_class toIEEE(const mpz_class& x, int wE, int wF) const;
+		/** Convert an IEEE-754 number with wE exponent and wF fraction bits to a posit.
+		    Infinities and NaNs become NaR, both zeros become 0 */
+		mpz_class fromIEEE(const mpz_class& f, int wE, int wF) const;
+
+		int N;
+		int es;
+
+	private:
+		uint64_t mask;
+		uint64_t narBits;
+	};
+
+}//namespace
+
+
+#endif
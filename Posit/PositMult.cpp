@@ -3,6 +3,7 @@
    entries */
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <vector>
 #include <math.h>
 #include <string.h>
@@ -13,9 +14,10 @@
 #include "utils.hpp"
 #include "Operator.hpp"
 #include "../ShiftersEtc/LZOC.hpp"
-#include "../ShiftersEtc/Shifters_signed.hpp"
 #include "../IntMult/IntMultiplier.hpp"
 #include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+#include "PositMultROM.hpp"
 
 // include the header of the Operator
 #include "PositMult.hpp"
@@ -26,8 +28,8 @@ namespace flopoco {
 	//extern vector<Operator *> oplist;
 
 
-	PositMult::PositMult(Target* target, int N, int es, map<string, double> inputDelays) :
-	Operator(target), N(N), es(es){
+	PositMult::PositMult(Target* target, int N, int es, bool exhaustive, int threads, bool decoded, bool faithful, int rom, bool varEs, bool report, bool cmodel, int wSF, int wF, int part, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), decoded(decoded), faithful(faithful), varEs(varEs), model(N, es), table(NULL), part(part), threads(threads), pool(NULL), batchFirst(0), coverage(PositCoverage::multBins(es)){
 		/* constructor of the PositMult
 		   Target is the targeted FPGA : Stratix, Virtex ... (see Target.hpp for more informations)
 		   param0 and param1 are some parameters declared by this Operator developpers, 
@@ -40,9 +42,42 @@ namespace flopoco {
 		// definition of the source file name, used for info and error reporting using REPORT 
 		srcFileName="PositMult";
 
+		RegSize = intlog2(N-1)+1;
+		// with varEs, the fractions are as wide as for es=0
+		FracSize = (varEs ? N-2 : N-es-2);
+		if((wSF != 0 || wF != 0) && !decoded)
+			THROWERROR("wSF and wF set the widths of decoded inputs, they need decoded=true");
+		if(wSF == 0)
+			wSF = RegSize+es;
+		if(wF == 0)
+			wF = FracSize;
+		this->wSF = wSF;
+		this->wF = wF;
+		if(wSF < RegSize+es || wF < FracSize)
+			THROWERROR("decoded inputs need wSF >= " << RegSize+es << " and wF >= " << FracSize << ", got wSF=" << wSF << " wF=" << wF);
+
+		if(rom == 1 && (decoded || varEs || N > 8))
+			THROWERROR("rom=1 needs posit inputs, a fixed es and N <= 8");
+		if(cmodel && (decoded || faithful || varEs || rom == 1))
+			THROWERROR("cmodel is only available for the datapath with posit inputs, a fixed es and the exact fraction product");
+		if(rom == -1)
+			useRom = !cmodel && !decoded && !varEs && N <= 8 && PositMultROM::lutCost(target, N) <= datapathLutCost(target);
+		else
+			useRom = (rom == 1);
+
 		// definition of the name of the operator
 		ostringstream name;
 		name << "PositMult_" << N << "_" << es ;
+		if(decoded)
+			name << "_decoded";
+		if(decoded && (wSF != RegSize+es || wF != FracSize))
+			name << "_" << wSF << "_" << wF;
+		if(faithful)
+			name << "_faithful";
+		if(useRom)
+			name << "_rom";
+		if(varEs)
+			name << "_vares";
 		setNameWithFreqAndUID(name.str());
 		// Copyright 
 		setCopyrightString("Raul Murillo, 2019");
@@ -50,14 +85,62 @@ namespace flopoco {
 		// the addition operators need the ieee_std_signed/unsigned libraries
 		//useNumericStd();
 
-		RegSize = intlog2(N);
-		FracSize = N-es-2;
+		if(exhaustive && decoded)
+			THROWERROR("exhaustive mode needs posit inputs, it is not available with decoded=true");
+		if(faithful && (exhaustive || decoded))
+			THROWERROR("faithful is not available with exhaustive=true or decoded=true, which expect the exact product");
+		if(varEs && (exhaustive || decoded))
+			THROWERROR("varEs is not available with exhaustive=true or decoded=true");
+		if(varEs && (es < 1 || es > N-4))
+			THROWERROR("varEs needs 1 <= es <= N-4, got es=" << es);
+		if(varEs)
+			for(int e = 0; e <= es; e++)
+				models.push_back(PositModel(N, e));
+		for(int e = 0; e <= es; e++)
+			multFunctions.push_back(positMultFunction(N, e));
+		if(exhaustive) {
+			if(N > 16)
+				THROWERROR("exhaustive mode is limited to N <= 16, got N=" << N);
+			if(part < 0 || part >= PositMultTable::sweepParts(N))
+				THROWERROR("posit" << N << " has " << PositMultTable::sweepParts(N) << " parts of input pairs, got part=" << part);
+			REPORT(INFO, "Loading the exhaustive product table " << PositMultTable::defaultFileName(N, es));
+			table = new PositMultTable(N, es);
+			uint64_t pairs = min(PositMultTable::sweepPartSize, ((uint64_t)1) << (2*N));
+			REPORT(INFO, "Run TestBench n=" << pairs << " for the input pairs " << part*pairs << " to " << (part+1)*pairs-1
+				   << (PositMultTable::sweepParts(N) > 1 ? ", and parts 0 to " + to_string(PositMultTable::sweepParts(N)-1) + " for all of them" : ""));
+		}
+		else if(part != 0)
+			THROWERROR("part selects input pairs of an exhaustive sweep, it needs exhaustive=true");
 
 
 		/* SET UP THE IO SIGNALS */
-		addInput  ( "InputA", N);
-		addInput  ( "InputB", N);
-		addOutput ( "Output", N);
+		if(decoded) {
+			// The decoded form of PositDecoder, SF being Reg & Exp, possibly wider
+			addInput  ( "SignA" );
+			addInput  ( "SFA", wSF);
+			addInput  ( "FracA", wF);
+			addInput  ( "zA" );
+			addInput  ( "infA" );
+			addInput  ( "SignB" );
+			addInput  ( "SFB", wSF);
+			addInput  ( "FracB", wF);
+			addInput  ( "zB" );
+			addInput  ( "infB" );
+			// The unrounded product, in the same form: it feeds a PositEncoder with wSF=wSF+1 wF=2*wF,
+			// or another decoded PositMult with these widths
+			addOutput ( "SignR" );
+			addOutput ( "SFR", wSF+1);
+			addOutput ( "FracR", 2*wF);
+			addOutput ( "zR" );
+			addOutput ( "infR" );
+		}
+		else {
+			addInput  ( "InputA", N);
+			addInput  ( "InputB", N);
+			if(varEs)
+				addInput  ( "ES", intlog2(es));
+			addOutput ( "Output", N);
+		}
 
 //		addFullComment(" addFullComment for a large comment ");
 //		addComment("addComment for small left-aligned comment");
@@ -82,26 +165,92 @@ namespace flopoco {
 		// debug message for developper
 		REPORT(DEBUG,"debug of PositMult");
 
+		if(useRom) {
+		//=========================================================================|
+			addFullComment("Product table");
+		// ========================================================================|
+			vhdl << tab << declare("addr", 2*N) << " <= InputA & InputB;" << endl;
+			PositMultROM* rom = (PositMultROM*) newInstance("PositMultROM", "rom", "N=" + to_string(N) + " es=" + to_string(es), "X=>addr;Y=>rom_out");
+			syncCycleFromSignal("rom_out");
+			setCriticalPath(rom->getOutputDelay("Y"));
+			costs.component(this, "product table", rom, PositMultROM::lutCost(target, N), 0, {"rom_out"});
+			vhdl << tab << "Output <= rom_out;" << endl;
+			if(report) {
+				REPORT(INFO, "Writing the estimated delays and resources to " << getName() << ".json");
+				costs.write(this);
+			}
+			return;
+		}
+
+		// The C++ model mirrors the signals of the datapath as it is built
+		PositCModel cm;
+		if(cmodel) {
+			cm.input("InputA", N);
+			cm.input("InputB", N);
+		}
+
 	//=========================================================================|
 		addFullComment("Data Extraction");
 	// ========================================================================|
 
-		PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
-		PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", "N=" + to_string(N) + " es=" + to_string(es), "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
-		syncCycleFromSignal("reg_A");
-		setCriticalPath(decoderA->getOutputDelay("Reg"));
-		syncCycleFromSignal("reg_B");
-		setCriticalPath(decoderB->getOutputDelay("Reg"));
-
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-
-		addComment("Gather scale factors");
-		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
-		if (es>0) vhdl << " & exp_A";
-		vhdl << ";" << endl;
-		vhdl << tab << declare("sf_B", RegSize+es) << " <= reg_B";
-		if (es>0) vhdl << " & exp_B";
-		vhdl << ";" << endl;
+		if(decoded) {
+			vhdl << tab << declare("sign_A") << " <= SignA;" << endl;
+			vhdl << tab << declare("sign_B") << " <= SignB;" << endl;
+			vhdl << tab << declare("sf_A", wSF) << " <= SFA;" << endl;
+			vhdl << tab << declare("sf_B", wSF) << " <= SFB;" << endl;
+			vhdl << tab << declare("frac_A", wF) << " <= FracA;" << endl;
+			vhdl << tab << declare("frac_B", wF) << " <= FracB;" << endl;
+			vhdl << tab << declare("z_A") << " <= zA;" << endl;
+			vhdl << tab << declare("z_B") << " <= zB;" << endl;
+			vhdl << tab << declare("inf_A") << " <= infA;" << endl;
+			vhdl << tab << declare("inf_B") << " <= infB;" << endl;
+		}
+		else {
+			string decParams = "N=" + to_string(N) + " es=" + to_string(es) + (varEs ? " varEs=true" : "");
+			string esPort = (varEs ? "ES=>ES;" : "");
+			PositDecoder* decoderA = (PositDecoder*) newInstance("PositDecoder", "decoderA", decParams, esPort + "Input=>InputA;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+			PositDecoder* decoderB = (PositDecoder*) newInstance("PositDecoder", "decoderB", decParams, esPort + "Input=>InputB;Sign=>sign_B;Reg=>reg_B;Exp=>exp_B;Frac=>frac_B;z=>z_B;inf=>inf_B");
+			syncCycleFromSignal("reg_A");
+			setCriticalPath(decoderA->getOutputDelay("Reg"));
+			costs.component(this, "decoderA", "PositDecoder", decoderA->getReport(), {"sign_A", "reg_A", "exp_A", "frac_A", "z_A", "inf_A"});
+			syncCycleFromSignal("reg_B");
+			setCriticalPath(decoderB->getOutputDelay("Reg"));
+			costs.component(this, "decoderB", "PositDecoder", decoderB->getReport(), {"sign_A", "reg_A", "exp_A", "frac_A", "z_A", "inf_A", "sign_B", "reg_B", "exp_B", "frac_B", "z_B", "inf_B"});
+
+			manageCriticalPath(target->localWireDelay() + target->lutDelay());
+
+			addComment("Gather scale factors");
+			for(string op : {"A", "B"}) {
+				vhdl << tab << declare("sf_" + op, RegSize+es) << " <= ";
+				if(varEs) {
+					// reg*2^ES + exp, exp having ES bits: the regime is sign-extended by es-ES bits.
+					// ES > es, which the port width allows when es+1 is not a power of 2, is taken as es
+					for(int e = es; e >= 0; e--) {
+						for(int i = 0; i < es-e; i++)
+							vhdl << "reg_" << op << "(reg_" << op << "'high) & ";
+						vhdl << "reg_" << op << (e > 0 ? " & exp_" + op + range(e-1, 0) : "");
+						vhdl << (e > 0 ? string(" when ES ") + (e == es ? ">= " : "= ") + to_string(e) + " else " : ";");
+					}
+				}
+				else {
+					vhdl << "reg_" << op;
+					if (es>0) vhdl << " & exp_" << op;
+					vhdl << ";";
+				}
+				vhdl << endl;
+			}
+			costs.stage(this, "scale factors", (varEs ? 2*(RegSize+es) : 0), {"sign_A", "sf_A", "frac_A", "z_A", "inf_A", "sign_B", "sf_B", "frac_B", "z_B", "inf_B"});
+
+			if(cmodel) {
+				decoderA->cModel(cm, "decoderA_", PositCModel::ref("InputA"), 0);
+				decoderB->cModel(cm, "decoderB_", PositCModel::ref("InputB"), 0);
+				for(string op : {"A", "B"}) {
+					string reg = PositCModel::ref("decoder" + op + "_Reg");
+					cm.signal("sf_" + op, RegSize+es, getSignalByName("sf_" + op)->getCycle(),
+							  (es > 0 ? "(" + reg + " << " + to_string(es) + ") | " + PositCModel::ref("decoder" + op + "_Exp") : reg));
+				}
+			}
+		}
 		
 	//=========================================================================|
 		addFullComment("Sign and Special Cases Computation");
@@ -115,114 +264,284 @@ namespace flopoco {
 		addFullComment("Multiply the fractions, add the exponent values");
 	// ========================================================================|
 
-		//int frac_size = getSignalByName("frac_A")->width();
-		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", "mult", "wX=" + to_string(FracSize) + " wY=" + to_string(FracSize) + " wOut="+ to_string(0), "X=>frac_A;Y=>frac_B;R=>frac_mult");
+		// A faithful product of wF+2 bits is within half an ulp of the largest posit fraction,
+		// so that its rounding is one of the two posits around the exact product
+		int wOut = 0;
+		if(faithful && wF+2 < 2*wF)
+			wOut = wF+2;
+		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", "mult", "wX=" + to_string(wF) + " wY=" + to_string(wF) + " wOut="+ to_string(wOut), "X=>frac_A;Y=>frac_B;R=>frac_mult");
 		syncCycleFromSignal("frac_mult");
 		setCriticalPath(mult->getOutputDelay("R"));
 
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
 		int mult_size = getSignalByName("frac_mult")->width();
+		int multLuts, multDsps;
+		PositReport::multiplierCost(target, wF, wF, wOut, multLuts, multDsps);
+		costs.component(this, "fraction product", mult, multLuts, multDsps, {"frac_mult", "sf_A", "sf_B", "sign", "z", "inf"});
 
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
 		addComment("Adjust for overflow");
 		vhdl << tab << declare("ovf_m") << " <= frac_mult(frac_mult'high);" << endl;
 
 		vhdl << tab << declare("normFrac", mult_size+1) << " <= frac_mult & '0' when ovf_m = '0' else"
 													<< " '0' & frac_mult;" << endl; // Equivalent to shift right ovf_m bits
-		vhdl << tab << declare("sf_mult", RegSize+es+1) << " <= (sf_A(sf_A'high) & sf_A) + (sf_B(sf_B'high) & sf_B) + ovf_m;" << endl;
+		costs.stage(this, "fraction normalisation", mult_size+1, {"normFrac", "ovf_m", "sf_A", "sf_B", "sign", "z", "inf"});
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(wSF+1));
+		vhdl << tab << declare("sf_mult", wSF+1) << " <= (sf_A(sf_A'high) & sf_A) + (sf_B(sf_B'high) & sf_B) + ovf_m;" << endl;
+		costs.stage(this, "scale factor sum", wSF+1, {"normFrac", "sf_mult", "sign", "z", "inf"});
+
+		if(cmodel) {
+			auto s = [](string name) {return PositCModel::ref(name);};
+			auto c = [this](string name) {return getSignalByName(name)->getCycle();};
+			cm.signal("sign", 1, c("sign"), s("decoderA_Sign") + " ^ " + s("decoderB_Sign"));
+			cm.signal("z", 1, c("z"), s("decoderA_z") + " | " + s("decoderB_z"));
+			cm.signal("inf", 1, c("inf"), s("decoderA_inf") + " | " + s("decoderB_inf"));
+			cm.signal("frac_mult", mult_size, c("frac_mult"), s("decoderA_Frac") + " * " + s("decoderB_Frac"));
+			cm.signal("ovf_m", 1, c("ovf_m"), s("frac_mult") + " >> " + to_string(mult_size-1));
+			cm.signal("normFrac", mult_size+1, c("normFrac"), s("ovf_m") + " ? " + s("frac_mult") + " : " + s("frac_mult") + " << 1");
+			cm.signal("sf_mult", RegSize+es+1, c("sf_mult"), "sext(" + s("sf_A") + ", " + to_string(RegSize+es) + ") + sext(" + s("sf_B") + ", " + to_string(RegSize+es) + ") + " + s("ovf_m"));
+		}
 
-		vhdl << tab << declare("sf_sign") << " <= sf_mult(sf_mult'high);" << endl;
 
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		if(decoded) {
+			addComment("Exact product, rounded by the PositEncoder ending the chain");
+			vhdl << tab << "SignR <= sign;" << endl;
+			vhdl << tab << "SFR <= sf_mult;" << endl;
+			vhdl << tab << "FracR <= normFrac" << range(mult_size-1, 0) << ";" << endl;
+			vhdl << tab << "zR <= z;" << endl;
+			vhdl << tab << "infR <= inf;" << endl;
+		}
+		else {
+		//=========================================================================|
+			addFullComment("Rounding and Packing");
+		// ========================================================================|
+
+			vhdl << tab << declare("normFracH", mult_size) << " <= normFrac" << range(mult_size-1, 0) << ";" << endl;
+			int encoderCycle = getCurrentCycle();
+			PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(wSF+1) + " wF=" + to_string(mult_size) + (varEs ? " varEs=true" : ""), string(varEs ? "ES=>ES;" : "") + "Sign=>sign;SF=>sf_mult;Frac=>normFracH;z=>z;inf=>inf;Output=>posit_out");
+			syncCycleFromSignal("posit_out");
+			setCriticalPath(encoder->getOutputDelay("Output"));
+			costs.component(this, "encoder", "PositEncoder", encoder->getReport(), {"posit_out"});
+
+			vhdl << tab << "Output <= posit_out;" << endl;
+
+			if(cmodel) {
+				cm.signal("normFracH", mult_size, getSignalByName("normFracH")->getCycle(), PositCModel::ref("normFrac"));
+				encoder->cModel(cm, "encoder_", {PositCModel::ref("sign"), PositCModel::ref("sf_mult"), PositCModel::ref("normFracH"), PositCModel::ref("z"), PositCModel::ref("inf")}, encoderCycle);
+				cm.signal("Output", N, getCurrentCycle(), PositCModel::ref("encoder_Output"));
+				if(cm.maxWidth() > 128)
+					THROWERROR("the C++ model needs signals of at most 128 bits, this one has " << cm.maxWidth() << " bits");
+				REPORT(INFO, "Writing the C++ model to " << getName() << "_model.hpp");
+				ofstream f(getName() + "_model.hpp");
+				cm.write(f, getName(), "Output", getCurrentCycle());
+			}
+		}
 
-	//=========================================================================|
-		addFullComment("Compute Regime and Exponent value");
-	// ========================================================================|
+		if(report) {
+			REPORT(INFO, "Writing the estimated delays and resources to " << getName() << ".json");
+			costs.write(this);
+		}
 
-		vhdl << tab << declare("nzero") << " <= '0' when frac_mult = 0 else '1';" << endl;
+	};
 
-		addComment("Unpack scaling factors");
-		if (es>0)
-			vhdl << tab << declare("ExpBits", es) << " <= sf_mult" << range(es-1,0) << ";" << endl;
-		vhdl << tab << declare("RegimeAns_tmp", RegSize) << " <= sf_mult" << range(RegSize+es-1,es) << ";" << endl;
-		nextCycle();
-		addComment("Get Regime's absolute value");
-		vhdl << tab << declare("RegimeAns", RegSize) << " <= (NOT RegimeAns_tmp)+1 when sf_sign = '1' else RegimeAns_tmp;" << endl;
+	
+	PositMult::~PositMult() {
+		for(TestCase* tc : batchTests)
+			delete tc;
+		delete pool;
+		delete table;
+	}
+
+
+	int PositMult::datapathLutCost(Target* target) {
+		// Rough LUT counts of the two decoders (LZOC, shifter, 2's complement),
+		// of the fraction multiplier when there are no DSP blocks, and of the encoder
+		int wS = intlog2(N-1);
+		int decoder = 3*(N-1) + (N-1)*wS;
+		int mult = (target->hasHardMultipliers() ? 0 : FracSize*FracSize/2);
+		int encoder = 3*N + 2*N*wS;
+		return 2*decoder + mult + encoder;
+	}
 
-		addComment("Check for Regime overflow");
-		vhdl << tab << declare("ovf_reg") << " <= RegimeAns(RegimeAns'high);" << endl;
-		vhdl << tab << declare("FinalRegime", RegSize) << " <= '0' & " << og(RegSize-1) << " when ovf_reg = '1' else "
-														<< "RegimeAns;" << endl;
 
-		nextCycle();											
-		vhdl << tab << declare("ovf_regF") << " <= '1' when FinalRegime = ('0' & " << og(RegSize-1) << ") else '0';" << endl;
-		nextCycle();
-		if (es>0){
-			vhdl << tab << declare("FinalExp", es) << " <= " << zg(es) << " when ((ovf_reg = '1') OR (ovf_regF = '1') OR (nzero='0')) else "
-														<< "ExpBits;" << endl;
+	void PositMult::emulate(TestCase * tc) {
+		if(decoded) {
+			emulateDecoded(tc);
+			return;
 		}
-		
-	//=========================================================================|
-		addFullComment("Packing Stage 1");
-	// ========================================================================|
+		// get the inputs from the TestCase
+		mpz_class svX = tc->getInputValue ( "InputA" );
+		mpz_class svY = tc->getInputValue ( "InputB" );
+		mpz_class svR;
+		int e = (varEs ? min((int)tc->getInputValue ( "ES" ).get_si(), es) : es);
+		const PositModel& m = (varEs ? models[e] : model);
+		if(faithful) {
+			// both posits around the exact product are accepted
+			mpz_class svLo, svHi;
+			m.multBracket(svX, svY, svLo, svHi);
+			tc->addExpectedOutput ( "Output", svLo );
+			if(svHi != svLo)
+				tc->addExpectedOutput ( "Output", svHi );
+			return;
+		}
+		if(table)
+			svR = mpz_class((unsigned long) table->mult(mpz_get_ui(svX.get_mpz_t()), mpz_get_ui(svY.get_mpz_t())));
+		else if(N <= 64)
+			svR = mpz_class((unsigned long) mult(mpz_get_ui(svX.get_mpz_t()), mpz_get_ui(svY.get_mpz_t()), e));
+		else
+			svR = m.mult(svX, svY);
+		// complete the TestCase with this expected output
+		tc->addExpectedOutput ( "Output", svR );
 
-		vhdl << tab << declare("tmp1", 2+es+mult_size-1) << " <= nzero & '0' ";
-		if (es>0)
-			vhdl << "& FinalExp ";
-		vhdl << "& normFrac" << range(mult_size-2,0) << ";" << endl;
-		vhdl << tab << declare("tmp2", 2+es+mult_size-1) << " <= '0' & nzero ";
-		if (es>0)
-			vhdl << "& FinalExp ";
-		vhdl << "& normFrac" << range(mult_size-2,0) << ";" << endl;
-		
-		vhdl << tab << declare("shift_neg", RegSize) << " <= FinalRegime - 2 when (ovf_regF = '1') else"
-													 << " FinalRegime - 1;" << endl;
- 		vhdl << tab << declare("shift_pos", RegSize) << " <= FinalRegime - 1 when (ovf_regF = '1') else"
-													 << " FinalRegime;" << endl;
-
-		vhdl << tab << declare("shifter_in", 2+es+mult_size-1) << " <= tmp2 when sf_sign = '1' else"
-																<< " tmp1;" << endl;
-		vhdl << tab << declare("shifter_S", RegSize) << " <= shift_neg when sf_sign = '1' else"
-													<< " shift_pos;" << endl;										 
-		Shifter_signed* rightShifter = (Shifter_signed*) newInstance("Shifter_signed", "RightShifterComponent", "wIn=" + to_string(2+es+mult_size-1) + " maxShift=" + to_string(N) + " dir=1", "X=>shifter_in;S=>shifter_S;R=>shifter_out");
-		syncCycleFromSignal("shifter_out");
-		setCriticalPath(rightShifter->getOutputDelay("R"));											 
+	}
 
-		manageCriticalPath(target->localWireDelay() + target->lutDelay());
-		int shift_size = getSignalByName("shifter_out")->width();
-		vhdl << tab << declare("tmp_ans", N-1) << " <= shifter_out" << range(shift_size-1, shift_size-(N-1)) << ";" << endl;
 
-	//=========================================================================|
-		addFullComment("Packing Stage 2 - Unbiased Rounding");
-	// ========================================================================|
-		// Rounding implementation using L,G,R,S bits
-		vhdl << tab << declare("LSB") << " <= shifter_out" << of(shift_size-(N-1)) << ";" << endl;
-		vhdl << tab << declare("G") << " <= shifter_out" << of(shift_size-(N-1)-1) << ";" << endl;
-		vhdl << tab << declare("R") << " <= shifter_out" << of(shift_size-(N-1)-2) << ";" << endl;
-		vhdl << tab << declare("S") << " <= '0' when shifter_out" << range(shift_size-(N-1)-3, 0) << " = 0 else '1';" << endl;
+	void PositMult::emulateDecoded(TestCase * tc) {
+		// Bit-exact copy of the datapath: no rounding, no special case handling
+		int wP = 2*wF;
+		mpz_class svSFA = tc->getInputValue ( "SFA" );
+		mpz_class svSFB = tc->getInputValue ( "SFB" );
+		if(svSFA >= (mpz_class(1) << (wSF-1)))
+			svSFA -= mpz_class(1) << wSF;
+		if(svSFB >= (mpz_class(1) << (wSF-1)))
+			svSFB -= mpz_class(1) << wSF;
+		mpz_class svP = tc->getInputValue ( "FracA" ) * tc->getInputValue ( "FracB" );
+		int ovf_m = mpz_tstbit(svP.get_mpz_t(), wP-1);
+		mpz_class svFrac = (ovf_m ? svP : mpz_class(svP << 1)) % (mpz_class(1) << wP);
+		mpz_class svSF = (svSFA + svSFB + ovf_m) % (mpz_class(1) << (wSF+1));
+		if(svSF < 0)
+			svSF += mpz_class(1) << (wSF+1);
+
+		tc->addExpectedOutput ( "SignR", tc->getInputValue ( "SignA" ) ^ tc->getInputValue ( "SignB" ) );
+		tc->addExpectedOutput ( "SFR", svSF );
+		tc->addExpectedOutput ( "FracR", svFrac );
+		tc->addExpectedOutput ( "zR", tc->getInputValue ( "zA" ) | tc->getInputValue ( "zB" ) );
+		tc->addExpectedOutput ( "infR", tc->getInputValue ( "infA" ) | tc->getInputValue ( "infB" ) );
+	}
 
-		vhdl << tab << declare("round") << " <= G AND (LSB OR R OR S) when NOT((ovf_reg OR ovf_regF) = '1') else '0';" << endl;
 
-		vhdl << tab << "Output <= '1' & " << zg(N-1) << " when inf = '1' else "
-							<< zg(N) << " when z = '1' else"
-							<< " '0' & (tmp_ans + round) when sign = '0' else"
-							<< " NOT('0' & (tmp_ans + round))+1;" << endl;
+	void PositMult::buildStandardTestCases(TestCaseList * tcl) {
+		if(decoded || N > 64)
+			return;
+		const uint64_t mask = model.nar() | model.maxpos();
+		vector<uint64_t> special = {model.zero(), model.nar(), ((uint64_t)1) << (N-2), model.minpos(), model.maxpos()};
+		for(int j = 2; j < 5; j++)
+			special.push_back((-special[j]) & mask);
+		vector<pair<uint64_t, uint64_t> > pairs;
+		for(uint64_t a : special)
+			for(uint64_t b : special)
+				pairs.push_back(make_pair(a, b));
+		if(!varEs) {
+			// The first biased test reaching each path not reached yet
+			uint32_t all = PositCoverage::mask(PositCoverage::multBins(es));
+			uint32_t reached = 0;
+			for(uint64_t i = 0; i < (1 << 20) && (reached & all) != all; i++) {
+				uint64_t a, b;
+				PositCoverage::multInputs(i, N, a, b);
+				uint32_t hits = PositCoverage::multHits(model, a, b) & ~reached;
+				if(hits & all) {
+					pairs.push_back(make_pair(a, b));
+					reached |= hits;
+				}
+			}
+		}
 
-	};
+		// with varEs, the largest value of the ES port too, taken as es when above it
+		int esMax = (varEs ? (1 << intlog2(es)) - 1 : es);
+		for(int e = es; e <= esMax; e += max(esMax-es, 1))
+			for(pair<uint64_t, uint64_t> p : pairs) {
+				TestCase* tc = new TestCase(this);
+				tc->addInput("InputA", mpz_class((unsigned long) p.first));
+				tc->addInput("InputB", mpz_class((unsigned long) p.second));
+				if(varEs)
+					tc->addInput("ES", mpz_class(e));
+				emulate(tc);
+				tcl->add(tc);
+			}
+	}
 
-	
-	void PositMult::emulate(TestCase * tc) {
-		// get the inputs from the TestCase
-		mpz_class svX = tc->getInputValue ( "InputA" );
-		// complete the TestCase with this expected output
-		tc->addExpectedOutput ( "Output", svX );
 
+	TestCase* PositMult::buildRandomTestCase(int i) {
+		if(decoded || N > 64 || faithful || varEs) {
+			TestCase *tc = new TestCase(this);
+			if(decoded) {
+				// Decoded operands, with few zeros and NaRs
+				const string op[2] = {"A", "B"};
+				for(int j = 0; j < 2; j++) {
+					mpz_class special = getLargeRandom(4);
+					tc->addInput("Sign" + op[j], getLargeRandom(1));
+					tc->addInput("SF" + op[j], getLargeRandom(wSF));
+					tc->addInput("Frac" + op[j], special == 0 ? mpz_class(0) : mpz_class(getLargeRandom(wF) | (mpz_class(1) << (wF-1))));
+					tc->addInput("z" + op[j], mpz_class(special == 0 ? 1 : 0));
+					tc->addInput("inf" + op[j], mpz_class(special == 1 ? 1 : 0));
+				}
+			}
+			else {
+				tc->addInput("InputA", getLargeRandom(N));
+				tc->addInput("InputB", getLargeRandom(N));
+				if(varEs)
+					tc->addInput("ES", PositTestVectors::randomEs(es));
+			}
+			emulate(tc);
+			return tc;
+		}
+
+		uint64_t idx = (table ? part*PositMultTable::sweepPartSize : 0) + (unsigned)i;
+		if(batchTests.empty() || idx < batchFirst || idx >= batchFirst + batchTests.size() || batchTests[idx-batchFirst] == NULL)
+			fillBatch(idx - idx % positTestBatchSize);
+		uint64_t k = idx - batchFirst;
+		if(!table) {
+			coverage.add(batchHits[k]);
+			if(PositCoverage::reportDue(coverage.tests()))
+				REPORT(INFO, "Coverage after " << coverage.tests() << " tests: " << coverage.summary());
+		}
+		TestCase* tc = batchTests[k];
+		batchTests[k] = NULL;
+		return tc;
 	}
 
 
-//	void PositMult::buildStandardTestCases(TestCaseList * tcl) {
-		// please fill me with regression tests or corner case tests!
-//	}
+	uint64_t PositMult::mult(uint64_t a, uint64_t b, int e) const {
+		if(multFunctions[e])
+			return multFunctions[e](a, b);
+		return (varEs ? models[e] : model).mult(a, b);
+	}
+
 
+	void PositMult::fillBatch(uint64_t first) {
+		for(TestCase* tc : batchTests)
+			delete tc;
+		batchFirst = first;
+		batchTests.assign(positTestBatchSize, NULL);
+		batchHits.resize(positTestBatchSize);
+		if(pool == NULL)
+			pool = new PositThreadPool(threads);
+		const uint64_t mask = (N == 64 ? ~((uint64_t)0) : (((uint64_t)1) << N) - 1);
+		PositMult* op = this;
+		pool->parallelFor(first, positTestBatchSize, [op, first, mask](uint64_t i) {
+				uint64_t a, b, r;
+				if(op->table) {
+					// Enumerate the 2^(2N) input pairs, i being a 64-bit pair index
+					a = (i >> op->N) & mask;
+					b = i & mask;
+					// no coverage: every path is reached, and a model product per pair would cost more than the lookup
+					r = op->table->mult(a, b);
+					op->batchHits[i-first] = 0;
+				}
+				else {
+					PositCoverage::multInputs(i, op->N, a, b);
+					// the expected output comes from posit<N,es> as in emulate, the model only classifies the test
+					r = op->mult(a, b, op->es);
+					op->batchHits[i-first] = PositCoverage::multHits(op->model, a, b);
+				}
+				// the test case too, with its mpz_class values, is built by the thread
+				TestCase* tc = new TestCase(op);
+				tc->addInput("InputA", mpz_class((unsigned long) a));
+				tc->addInput("InputB", mpz_class((unsigned long) b));
+				tc->addExpectedOutput("Output", mpz_class((unsigned long) r));
+				op->batchTests[i-first] = tc;
+			});
+		REPORT(DEBUG, "Computed test vectors " << first << " to " << first + positTestBatchSize - 1);
+	}
 
 
 	OperatorPtr PositMult::parseArguments(Target *target, vector<string> &args) {
@@ -230,7 +549,29 @@ namespace flopoco {
 		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
 		int es;
 		UserInterface::parsePositiveInt(args, "es", &es);
-		return new PositMult(target, N, es);
+		bool exhaustive;
+		UserInterface::parseBoolean(args, "exhaustive", &exhaustive);
+		int threads;
+		UserInterface::parsePositiveInt(args, "threads", &threads);
+		bool decoded;
+		UserInterface::parseBoolean(args, "decoded", &decoded);
+		bool faithful;
+		UserInterface::parseBoolean(args, "faithful", &faithful);
+		int rom;
+		UserInterface::parseInt(args, "rom", &rom);
+		bool varEs;
+		UserInterface::parseBoolean(args, "varEs", &varEs);
+		bool report;
+		UserInterface::parseBoolean(args, "report", &report);
+		bool cmodel;
+		UserInterface::parseBoolean(args, "cmodel", &cmodel);
+		int wSF;
+		UserInterface::parsePositiveInt(args, "wSF", &wSF);
+		int wF;
+		UserInterface::parsePositiveInt(args, "wF", &wF);
+		int part;
+		UserInterface::parsePositiveInt(args, "part", &part);
+		return new PositMult(target, N, es, exhaustive, threads, decoded, faithful, rom, varEs, report, cmodel, wSF, wF, part);
 		
 	}
 
@@ -239,13 +580,24 @@ namespace flopoco {
 		UserInterface::add("PositMult", // name
 											 "A posit decoder with a single architecture.", // description, string
 											 "Posit", // category, from the list defined in UserInterface.cpp
-											 "", //seeAlso
+											 "PositDecoder,PositEncoder", //seeAlso
 											 // Now comes the parameter description string.
 											 // Respect its syntax because it will be used to generate the parser and the docs
 											 // Syntax is: a semicolon-separated list of parameterDescription;
 											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString 
 											 "N(int): A first parameter, here used as the input size; \
-                        					 es(int): A second parameter, here used as the exponent size of the Posit;",
+                        					 es(int): A second parameter, here used as the exponent size of the Posit; \
+                        					 exhaustive(bool)=false: use a product table cached on disk (N<=16) for emulate, and enumerate all the input pairs as test cases; \
+                        					 part(int)=0: with exhaustive, the part of 2^30 input pairs to enumerate, posit16 having 4 of them; \
+                        					 threads(int)=0: number of threads generating the test vectors, 0 for all cores; \
+                        					 decoded(bool)=false: take and return the decoded form of PositDecoder, the product being exact and left unrounded for a PositEncoder or another decoded PositMult; \
+                        					 wSF(int)=0: with decoded, the width of the input scale factors, 0 for that of PositDecoder; \
+                        					 wF(int)=0: with decoded, the width of the input fractions, 0 for that of PositDecoder; \
+                        					 faithful(bool)=false: truncated fraction multiplier, the result being one of the two posits around the exact product; \
+                        					 rom(int)=0: 1 for a single product table (N<=8), 0 for the datapath, -1 for the one with fewer estimated LUTs; \
+                        					 varEs(bool)=false: es is the largest exponent size, the actual one being the ES input; \
+                        					 report(bool)=false: write the estimated pipeline depth, delays and resources of each stage to <name>.json; \
+                        					 cmodel(bool)=false: write a cycle-accurate C++ model of the pipeline to <name>_model.hpp, for the datapath with a fixed es and the exact product",
 											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
 											 "Feel free to experiment with its code, it will not break anything in FloPoCo. <br> Also see the developper manual in the doc/ directory of FloPoCo.",
 											 PositMult::parseArguments
@@ -19,6 +19,12 @@
 
 #include "Operator.hpp"
 #include "../Target.hpp"
+#include "PositModel.hpp"
+#include "PositType.hpp"
+#include "PositReport.hpp"
+#include "PositCoverage.hpp"
+#include "PositMultTable.hpp"
+#include "PositTestVectors.hpp"
 
 
 /*  All flopoco operators and utility functions are declared within
@@ -38,9 +44,62 @@ namespace flopoco {
 		int N;
 		/** The width of the exponent */ 
 		int es;
+		/** Decoded inputs and unrounded decoded output, for chaining in the decoded domain */
+		bool decoded;
+		/** Truncated fraction multiplier, faithful result */
+		bool faithful;
+		/** The whole operator is a PositMultROM */
+		bool useRom;
+		/** es is the largest exponent size, the actual one being the ES input */
+		bool varEs;
 
 		int RegSize;
 		int FracSize;
+		/** The widths of the scale factors and fractions of the operands: those of PositDecoder,
+		    or wider ones with decoded, e.g. the outputs of another decoded PositMult */
+		int wSF;
+		int wF;
+
+		/** Software model used by emulate */
+		PositModel model;
+		/** Software models for each exponent size up to es, when varEs */
+		vector<PositModel> models;
+		/** The posit<N,e> products for each exponent size e up to es, NULL for the formats
+		    positMultFunction does not instantiate */
+		vector<PositMultFunction> multFunctions;
+		/** Exhaustive product table, NULL unless in exhaustive mode */
+		PositMultTable* table;
+		/** The part of the exhaustive sweep enumerated by the random tests */
+		int part;
+
+		/** Worker threads for test vector generation, 0 for all cores */
+		int threads;
+		/** The threads, started with the first batch */
+		PositThreadPool* pool;
+		/** Current batch of test vectors, starting at test batchFirst: the test cases are
+		    built by the threads, and handed over to the TestBench one by one */
+		uint64_t batchFirst;
+		vector<TestCase*> batchTests;
+		/** The coverage bins of each test of the batch */
+		vector<uint32_t> batchHits;
+		/** The paths reached by the random tests so far */
+		PositCoverage coverage;
+
+		/** The product of two N-bit posits with exponent size e, N <= 64: by posit<N,e>
+		    when instantiated, by the software model otherwise */
+		uint64_t mult(uint64_t a, uint64_t b, int e) const;
+
+		/** Compute the batch of test vectors starting at test first, in parallel */
+		void fillBatch(uint64_t first);
+
+		/** emulate for the decoded variant */
+		void emulateDecoded(TestCase * tc);
+
+		/** Estimated number of LUTs of the decoders, multiplier and encoder */
+		int datapathLutCost(Target* target);
+
+		/** Estimated delays and resources, stage by stage */
+		PositReport costs;
 
 
 	public:
@@ -49,25 +108,47 @@ namespace flopoco {
 		/** The constructor 
 		    * @param N The size of the inputs.
 		    * @param es The width of the exponent.
+		    * @param exhaustive Use an exhaustive product table (N <= 16) for testing.
+		    * @param threads The number of threads generating test vectors, 0 for all cores.
+		    * @param decoded Work in the decoded domain: no decoders, no rounding.
+		    * @param faithful Compute only FracSize+2 bits of the fraction product: the result is faithful, not correctly rounded.
+		    * @param rom 1 for a single product table (N <= 8), 0 for the datapath, -1 for the one with fewer estimated LUTs.
+		    * @param varEs es is the largest exponent size, the actual one being the ES input.
+		    * @param report Write the estimated delays and resources to <name>.json.
+		    * @param cmodel Write a cycle-accurate C++ model of the pipeline to <name>_model.hpp.
+		    * @param wSF With decoded, the width of the input scale factors, 0 for RegSize+es.
+		    * @param wF With decoded, the width of the input fractions, hidden bit included, 0 for FracSize.
+		    * @param part In exhaustive mode, the part of the input pairs to enumerate, see PositMultTable::sweepPartSize.
 		    */
-		PositMult(Target* target,int N = 8, int es = 0, map<string, double> inputDelays = emptyDelayMap);
+		PositMult(Target* target,int N = 8, int es = 0, bool exhaustive = false, int threads = 0, bool decoded = false, bool faithful = false, int rom = 0, bool varEs = false, bool report = false, bool cmodel = false, int wSF = 0, int wF = 0, int part = 0, map<string, double> inputDelays = emptyDelayMap);
 
 		// destructor
-		~PositMult() {};
+		~PositMult();
+
+		/** The estimated delays and resources */
+		const PositReport& getReport() const {return costs;}
+
+		/** The paths reached by the random tests so far */
+		const PositCoverage& getCoverage() const {return coverage;}
 
 
 		// Below all the functions needed to test the operator
 		/* the emulate function is used to simulate in software the operator
-		   in order to compare this result with those outputed by the vhdl opertator */
+		   in order to compare this result with those outputed by the vhdl opertator.
+		   If faithful, both posits around the exact product are expected */
 		void emulate(TestCase * tc);
 
-		/* function used to create Standard testCase defined by the developper */
-//		void buildStandardTestCases(TestCaseList* tcl);
+		/* function used to create Standard testCase defined by the developper:
+		   the products of special values, and a first test of each path of PositCoverage */
+		void buildStandardTestCases(TestCaseList* tcl);
 
 
 		/* function used to bias the (uniform by default) random test generator
-		   See FPExp.cpp for an example */
-//		TestCase* buildRandomTestCase(int i);
+		   See FPExp.cpp for an example
+		   In exhaustive mode, test i is the pair of inputs part*PositMultTable::sweepPartSize + i.
+		   For N <= 64 tests are computed by batches on several threads, biased towards
+		   saturation, ties and special values (see PositCoverage), and the paths they reach are reported */
+		TestCase* buildRandomTestCase(int i);
 
 		/** Factory method that parses arguments and calls the constructor */
 		static OperatorPtr parseArguments(Target *target , vector<string> &args);
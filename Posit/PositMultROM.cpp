@@ -0,0 +1,71 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <gmp.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+
+// include the header of the Operator
+#include "PositMultROM.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositMultROM::PositMultROM(Target* target, int N, int es) :
+	Table(target, 2*N, N), N(N), es(es), model(N, es) {
+
+		srcFileName="PositMultROM";
+
+		if(N > 8)
+			THROWERROR("the product table has 2^(2N) entries, it is limited to N <= 8, got N=" << N);
+
+		ostringstream name;
+		name << "PositMultROM_" << N << "_" << es;
+		setNameWithFreqAndUID(name.str());
+		setCopyrightString("Raul Murillo, 2019");
+	};
+
+
+	mpz_class PositMultROM::function(int x) {
+		uint64_t a = ((uint64_t)x) >> N;
+		uint64_t b = ((uint64_t)x) & ((((uint64_t)1) << N) - 1);
+		return mpz_class((unsigned long) model.mult(a, b));
+	}
+
+
+	int PositMultROM::lutCost(Target* target, int N) {
+		// N outputs, each a function of 2N bits, built from lutInputs()-input LUTs
+		int k = target->lutInputs();
+		return (2*N > k ? N << (2*N - k) : N);
+	}
+
+
+	OperatorPtr PositMultROM::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		return new PositMultROM(target, N, es);
+	}
+
+
+	void PositMultROM::registerFactory(){
+		UserInterface::add("PositMultROM", // name
+											 "A posit multiplier as a single table, for N <= 8.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size, at most 8; \
+                        					 es(int): The exponent size",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "The input is InputA & InputB. Usually instantiated by PositMult rom=1.",
+											 PositMultROM::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,66 @@
+/*
+  Posit multiplier as a single table.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MULT_ROM_HPP
+#define POSIT_MULT_ROM_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "../Table.hpp"
+#include "PositModel.hpp"
+
+
+namespace flopoco {
+
+	/** The posit<N,es> product as a 2^(2N)-entry table, filled from PositModel.
+	    The input X is InputA & InputB and the output Y is the product.
+	    Used by PositMult for N <= 8, where it may replace the whole datapath. */
+	class PositMultROM : public Table {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+
+		/** Software model filling the table */
+		PositModel model;
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits, at most 8.
+		    * @param es The width of the exponent.
+		    */
+		PositMultROM(Target* target, int N = 8, int es = 0);
+
+		// destructor
+		~PositMultROM() {};
+
+		/** The content of the table */
+		mpz_class function(int x);
+
+		/** Estimated number of LUTs of the table implemented as logic */
+		static int lutCost(Target* target, int N);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
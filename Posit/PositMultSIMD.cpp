@@ -0,0 +1,474 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+
+// include the header of the Operator
+#include "PositMultSIMD.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositMultSIMD::PositMultSIMD(Target* target, int N, int es, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), modelFull(N, es), modelHalf(N/2, es), modelQuarter(N/4, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositMultSIMD";
+
+		if(N % 4 != 0)
+			THROWERROR("N must be a multiple of 4, got N=" << N);
+		Q = N/4;
+		if(Q-es-2 < 1)
+			THROWERROR("the N/4-bit lanes need at least one fraction bit: N/4 >= es+3");
+		wA = intlog2(N-1);
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositMultSIMD_" << N << "_" << es;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "InputA", N);
+		addInput  ( "InputB", N);
+		addInput  ( "mode", 2);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositMultSIMD \n");
+		REPORT(DETAILED, "this operator has received two parameters " << N << " and " << es);
+
+		addComment("Lanes of N/2 bits when split2, of N/4 bits when split4");
+		vhdl << tab << declare("split2") << " <= '0' when mode = \"00\" else '1';" << endl;
+		vhdl << tab << declare("split4") << " <= mode(1);" << endl;
+		vhdl << tab << declare("zero_ozb") << " <= '0';" << endl;
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+
+		decode("A");
+		decode("B");
+
+	//=========================================================================|
+		addFullComment("Multiply the fractions - 16 quarter sub-products");
+	// ========================================================================|
+
+		for(int i = 0; i < 4; i++) {
+			vhdl << tab << declare("fq_A_q" + to_string(i), Q) << " <= f_A" << range(i*Q+Q-1, i*Q) << ";" << endl;
+			vhdl << tab << declare("fq_B_q" + to_string(i), Q) << " <= f_B" << range(i*Q+Q-1, i*Q) << ";" << endl;
+		}
+		for(int i = 0; i < 4; i++) {
+			for(int j = 0; j < 4; j++) {
+				string pp = "pp_" + to_string(i) + "_" + to_string(j);
+				IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", "mult_" + to_string(i) + "_" + to_string(j), "wX=" + to_string(Q) + " wY=" + to_string(Q) + " wOut=0", "X=>fq_A_q" + to_string(i) + ";Y=>fq_B_q" + to_string(j) + ";R=>" + pp);
+				syncCycleFromSignal(pp);
+				setCriticalPath(mult->getOutputDelay("R"));
+			}
+		}
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+
+		addComment("Half products only use the sub-products of their quarters");
+		for(int h = 0; h < 2; h++) {
+			string a = to_string(2*h), b = to_string(2*h+1);
+			vhdl << tab << declare("ph_" + to_string(h), N) << " <= (" << zg(2*Q) << " & pp_" << a << "_" << a << ")"
+				<< " + (" << zg(Q) << " & pp_" << a << "_" << b << " & " << zg(Q) << ")"
+				<< " + (" << zg(Q) << " & pp_" << b << "_" << a << " & " << zg(Q) << ")"
+				<< " + (pp_" << b << "_" << b << " & " << zg(2*Q) << ");" << endl;
+		}
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(N));
+
+		addComment("The full product adds the cross sub-products to the half products");
+		vhdl << tab << declare("pf", 2*N) << " <= (ph_1 & ph_0)";
+		for(int i = 0; i < 2; i++) {
+			for(int j = 2; j < 4; j++) {
+				int s = Q*(i+j);
+				vhdl << endl << tab << tab << " + (" << zg(2*N-2*Q-s) << " & pp_" << i << "_" << j << " & " << zg(s) << ")";
+				vhdl << " + (" << zg(2*N-2*Q-s) << " & pp_" << j << "_" << i << " & " << zg(s) << ")";
+			}
+		}
+		vhdl << ";" << endl;
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(2*N));
+
+		modeMux("pall", 2*N, "pf", "ph_1 & ph_0", "pp_3_3 & pp_2_2 & pp_1_1 & pp_0_0");
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing, per lane");
+	// ========================================================================|
+
+		string pin[3], tr[3];
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			int L2 = 2*L;
+			int wK = intlog2(L-1)+1;
+			int wSF = wK+es+1;
+			int rs = intlog2(L-1);
+			int nfr = L-es-1;
+			string regMax = "\"" + unsignedBinary(mpz_class(L-1), rs) + "\"";
+			for(int l = (1 << m)-1; l >= 0; l--) {
+				int lo2 = l*L2;
+				addComment("Lane " + to_string(l) + " of " + to_string(L) + " bits");
+				vhdl << tab << declare(ml("pr", m, l), L2) << " <= pall" << range(lo2+L2-1, lo2) << ";" << endl;
+				vhdl << tab << declare(ml("ovfm", m, l)) << " <= " << ml("pr", m, l) << of(L2-1) << ";" << endl;
+				vhdl << tab << declare(ml("frm", m, l), L2-1) << " <= " << ml("pr", m, l) << range(L2-2, 0) << " when " << ml("ovfm", m, l) << " = '1' else "
+					<< ml("pr", m, l) << range(L2-3, 0) << " & '0';" << endl;
+				vhdl << tab << declare(ml("stk", m, l)) << " <= '0' when " << ml("frm", m, l) << range(L2-2-nfr, 0) << " = 0 else '1';" << endl;
+				vhdl << tab << declare(ml("sfm", m, l), wSF) << " <= (" << ml("sf_A", m, l) << of(wSF-2) << " & " << ml("sf_A", m, l) << ")"
+					<< " + (" << ml("sf_B", m, l) << of(wSF-2) << " & " << ml("sf_B", m, l) << ") + " << ml("ovfm", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("sgn", m, l)) << " <= " << ml("s_A", m, l) << " XOR " << ml("s_B", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("zr", m, l)) << " <= " << ml("z_A", m, l) << " OR " << ml("z_B", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("ir", m, l)) << " <= " << ml("inf_A", m, l) << " OR " << ml("inf_B", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("nzr", m, l)) << " <= NOT " << ml("zr", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("sfs", m, l)) << " <= " << ml("sfm", m, l) << of(wSF-1) << ";" << endl;
+
+				vhdl << tab << declare(ml("rgt", m, l), wSF-es) << " <= " << ml("sfm", m, l) << range(wSF-1, es) << ";" << endl;
+				vhdl << tab << declare(ml("rga", m, l), wSF-es) << " <= (NOT " << ml("rgt", m, l) << ")+1 when " << ml("sfs", m, l) << " = '1' else " << ml("rgt", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("ovr", m, l)) << " <= '1' when " << ml("rga", m, l) << " > " << L-1 << " else '0';" << endl;
+				vhdl << tab << declare(ml("frg", m, l), rs) << " <= " << regMax << " when " << ml("ovr", m, l) << " = '1' else " << ml("rga", m, l) << range(rs-1, 0) << ";" << endl;
+				vhdl << tab << declare(ml("ovrf", m, l)) << " <= '1' when " << ml("frg", m, l) << " = " << regMax << " else '0';" << endl;
+				if (es>0)
+					vhdl << tab << declare(ml("fex", m, l), es) << " <= " << zg(es) << " when ((" << ml("ovr", m, l) << " = '1') OR (" << ml("ovrf", m, l) << " = '1') OR (" << ml("zr", m, l) << " = '1')) else "
+						<< ml("sfm", m, l) << range(es-1, 0) << ";" << endl;
+				vhdl << tab << declare(ml("hd", m, l), 2) << " <= ('0' & " << ml("nzr", m, l) << ") when " << ml("sfs", m, l) << " = '1' else (" << ml("nzr", m, l) << " & '0');" << endl;
+
+				vhdl << tab << declare(ml("shn", m, l), rs) << " <= " << ml("frg", m, l) << " - 2 when " << ml("ovrf", m, l) << " = '1' else " << ml("frg", m, l) << " - 1;" << endl;
+				vhdl << tab << declare(ml("shp", m, l), rs) << " <= " << ml("frg", m, l) << " - 1 when " << ml("ovrf", m, l) << " = '1' else " << ml("frg", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("shs", m, l), rs) << " <= " << ml("shn", m, l) << " when " << ml("sfs", m, l) << " = '1' else " << ml("shp", m, l) << ";" << endl;
+				vhdl << tab << declare(ml("psh", m, l), wA) << " <= " << (wA > rs ? zg(wA-rs) + " & " : "") << ml("shs", m, l) << ";" << endl;
+
+				// The lane keeps the L-es-1 fraction bits that may be packed, then a sticky bit,
+				// then L-2 zeros that absorb the right shift
+				pin[m] += ml("hd", m, l) + (es > 0 ? " & " + ml("fex", m, l) : "") + " & " + ml("frm", m, l) + range(L2-2, L2-1-nfr)
+					+ " & " + ml("stk", m, l) + " & " + zg(L-2) + (l > 0 ? " & " : "");
+				tr[m] += "'0' & " + ml("tmp", m, l) + (l > 0 ? " & " : "");
+			}
+		}
+		manageCriticalPath(target->localWireDelay() + target->adderDelay(N));
+		modeMux("pin", 2*N, pin[0], pin[1], pin[2]);
+		broadcast("psh", wA);
+		laneShifter("pin", "psh", "pout", 2*N, true);
+
+	//=========================================================================|
+		addFullComment("Unbiased Rounding and Sign, per lane");
+	// ========================================================================|
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			for(int l = 0; l < (1 << m); l++) {
+				int lo2 = l*2*L;
+				vhdl << tab << declare(ml("tmp", m, l), L-1) << " <= pout" << range(lo2+2*L-1, lo2+L+1) << ";" << endl;
+				vhdl << tab << declare(ml("lsb", m, l)) << " <= pout" << of(lo2+L+1) << ";" << endl;
+				vhdl << tab << declare(ml("grd", m, l)) << " <= pout" << of(lo2+L) << ";" << endl;
+				vhdl << tab << declare(ml("rbt", m, l)) << " <= pout" << of(lo2+L-1) << ";" << endl;
+				vhdl << tab << declare(ml("sbt", m, l)) << " <= '0' when pout" << range(lo2+L-2, lo2) << " = 0 else '1';" << endl;
+				vhdl << tab << declare(ml("rnd", m, l)) << " <= " << ml("grd", m, l) << " AND (" << ml("lsb", m, l) << " OR " << ml("rbt", m, l) << " OR " << ml("sbt", m, l) << ")"
+					<< " when NOT((" << ml("ovr", m, l) << " OR " << ml("ovrf", m, l) << ") = '1') else '0';" << endl;
+			}
+		}
+		modeMux("tr", N, tr[0], tr[1], tr[2]);
+		broadcast("rnd", 1);
+		broadcast("sgn", 1);
+		addComment("Round and restore the sign with one increment: -(tr + rnd) = NOT(tr) + NOT(rnd)");
+		for(int q = 0; q < 4; q++) {
+			vhdl << tab << declare("sgm_q" + to_string(q), Q) << " <= (others => sgn_q" << q << ");" << endl;
+			vhdl << tab << declare("rsg_q" + to_string(q)) << " <= rnd_q" << q << " XOR sgn_q" << q << ";" << endl;
+		}
+		vhdl << tab << declare("tx", N) << " <= tr XOR (sgm_q3 & sgm_q2 & sgm_q1 & sgm_q0);" << endl;
+		laneIncrement("tx", "rsg", "tr2");
+
+		broadcast("zr", 1);
+		broadcast("ir", 1);
+		addComment("NaR sets the MSB of its lane: the top quarter of the lane");
+		for(int q = 0; q < 4; q++) {
+			string nar = (q == 3 ? "ir_q3" : "(ir_q" + to_string(q) + " AND " + (q == 1 ? "split2" : "split4") + ")");
+			vhdl << tab << declare("res_q" + to_string(q), Q) << " <= tr2" << range(q*Q+Q-1, q*Q) << " when (ir_q" << q << " OR zr_q" << q << ") = '0' else" << endl
+				<< tab << tab << "\"1" << string(Q-1, '0') << "\" when " << nar << " = '1' else " << zg(Q) << ";" << endl;
+		}
+		vhdl << tab << "Output <= res_q3 & res_q2 & res_q1 & res_q0;" << endl;
+
+	};
+
+
+	string PositMultSIMD::ml(string base, int m, int l) {
+		return base + "_m" + to_string(m) + "_l" + to_string(l);
+	}
+
+
+	string PositMultSIMD::laneOfQuarter(string base, int q) {
+		return ml(base, 0, 0) + " when split2 = '0' else " + ml(base, 1, q/2) + " when split4 = '0' else " + ml(base, 2, q);
+	}
+
+
+	void PositMultSIMD::broadcast(string base, int w) {
+		for(int q = 0; q < 4; q++) {
+			string name = base + "_q" + to_string(q);
+			vhdl << tab << (w == 1 ? declare(name) : declare(name, w)) << " <= " << laneOfQuarter(base, q) << ";" << endl;
+		}
+	}
+
+
+	void PositMultSIMD::modeMux(string r, int W, string e0, string e1, string e2) {
+		vhdl << tab << declare(r, W) << " <= " << e0 << " when split2 = '0' else" << endl
+			<< tab << tab << e1 << " when split4 = '0' else" << endl
+			<< tab << tab << e2 << ";" << endl;
+	}
+
+
+	string PositMultSIMD::bits(string x, vector<int> idx) {
+		ostringstream s;
+		size_t i = 0;
+		while(i < idx.size()) {
+			size_t j = i;
+			if(idx[i] < 0) {
+				while(j+1 < idx.size() && idx[j+1] < 0)
+					j++;
+				s << zg(j-i+1);
+			}
+			else {
+				while(j+1 < idx.size() && idx[j+1] >= 0 && idx[j+1] == idx[j]-1)
+					j++;
+				s << x << (j == i ? of(idx[i]) : range(idx[i], idx[j]));
+			}
+			if(j+1 < idx.size())
+				s << " & ";
+			i = j+1;
+		}
+		return s.str();
+	}
+
+
+	void PositMultSIMD::laneIncrement(string x, string cin, string r) {
+		// Quarter 2 starts a lane when split2, quarters 1 and 3 when split4
+		for(int q = 0; q < 4; q++) {
+			string c = r + "_cin_q" + to_string(q);
+			if(q == 0)
+				vhdl << tab << declare(c) << " <= " << cin << "_q0;" << endl;
+			else
+				vhdl << tab << declare(c) << " <= " << cin << "_q" << q << " when " << (q == 2 ? "split2" : "split4") << " = '1' else "
+					<< r << "_c_q" << q-1 << ";" << endl;
+			vhdl << tab << declare(r + "_sum_q" + to_string(q), Q+1) << " <= ('0' & " << x << range(q*Q+Q-1, q*Q) << ") + " << c << ";" << endl;
+			if(q < 3)
+				vhdl << tab << declare(r + "_c_q" + to_string(q)) << " <= " << r << "_sum_q" << q << of(Q) << ";" << endl;
+		}
+		vhdl << tab << declare(r, N) << " <= " << r << "_sum_q3" << range(Q-1, 0) << " & " << r << "_sum_q2" << range(Q-1, 0)
+			<< " & " << r << "_sum_q1" << range(Q-1, 0) << " & " << r << "_sum_q0" << range(Q-1, 0) << ";" << endl;
+		manageCriticalPath(getTarget()->localWireDelay() + getTarget()->adderDelay(N));
+	}
+
+
+	void PositMultSIMD::laneShifter(string x, string amt, string r, int W, bool right) {
+		int S = W/4;
+		string in = x;
+		for(int j = 0; j < wA; j++) {
+			string st = r + "_s" + to_string(j);
+			for(int q = 0; q < 4; q++) {
+				string e[3];
+				for(int m = 0; m < 3; m++) {
+					int laneW = W >> m;
+					vector<int> idx;
+					for(int i = q*S+S-1; i >= q*S; i--) {
+						int start = i - i % laneW;
+						if(right)
+							idx.push_back(min(i + (1 << j), start+laneW-1));
+						else
+							idx.push_back(i - (1 << j) >= start ? i - (1 << j) : -1);
+					}
+					e[m] = bits(in, idx);
+				}
+				vhdl << tab << declare(st + "_q" + to_string(q), S) << " <= " << in << range(q*S+S-1, q*S) << " when " << amt << "_q" << q << of(j) << " = '0' else" << endl;
+				if(e[0] == e[1] && e[1] == e[2])
+					vhdl << tab << tab << e[0] << ";" << endl;
+				else
+					vhdl << tab << tab << e[0] << " when split2 = '0' else" << endl
+						<< tab << tab << e[1] << " when split4 = '0' else" << endl
+						<< tab << tab << e[2] << ";" << endl;
+			}
+			vhdl << tab << declare(st, W) << " <= " << st << "_q3 & " << st << "_q2 & " << st << "_q1 & " << st << "_q0;" << endl;
+			manageCriticalPath(getTarget()->localWireDelay() + getTarget()->lutDelay());
+			in = st;
+		}
+		vhdl << tab << declare(r, W) << " <= " << in << ";" << endl;
+	}
+
+
+	void PositMultSIMD::decode(string X) {
+		string in = "Input" + X;
+
+		addComment("Lane zero and NaR flags, from quarter flags");
+		for(int q = 0; q < 4; q++) {
+			vhdl << tab << declare("qz_" + X + "_q" + to_string(q)) << " <= '1' when " << in << range(q*Q+Q-1, q*Q) << " = 0 else '0';" << endl;
+			vhdl << tab << declare("qi_" + X + "_q" + to_string(q)) << " <= '1' when " << in << range(q*Q+Q-1, q*Q) << " = \"1" << string(Q-1, '0') << "\" else '0';" << endl;
+		}
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			int qs = 4 >> m;
+			for(int l = 0; l < (1 << m); l++) {
+				int top = l*qs+qs-1;
+				vhdl << tab << declare(ml("z_" + X, m, l)) << " <= ";
+				for(int q = top; q >= l*qs; q--)
+					vhdl << "qz_" << X << "_q" << q << (q > l*qs ? " AND " : ";\n");
+				vhdl << tab << declare(ml("inf_" + X, m, l)) << " <= qi_" << X << "_q" << top;
+				for(int q = top-1; q >= l*qs; q--)
+					vhdl << " AND qz_" << X << "_q" << q;
+				vhdl << ";" << endl;
+				vhdl << tab << declare(ml("s_" + X, m, l)) << " <= " << in << of(l*L+L-1) << ";" << endl;
+			}
+		}
+		broadcast("s_" + X, 1);
+
+		addComment("Absolute values");
+		for(int q = 0; q < 4; q++)
+			vhdl << tab << declare("sm_" + X + "_q" + to_string(q), Q) << " <= (others => s_" << X << "_q" << q << ");" << endl;
+		vhdl << tab << declare("xr_" + X, N) << " <= " << in << " XOR (sm_" << X << "_q3 & sm_" << X << "_q2 & sm_" << X << "_q1 & sm_" << X << "_q0);" << endl;
+		laneIncrement("xr_" + X, "s_" + X, "ax_" + X);
+
+		addComment("Count the regime bits: the ones equal to the first bit after the sign");
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			for(int l = 0; l < (1 << m); l++)
+				vhdl << tab << declare(ml("r_" + X, m, l)) << " <= ax_" << X << of(l*L+L-2) << ";" << endl;
+		}
+		broadcast("r_" + X, 1);
+		for(int q = 0; q < 4; q++)
+			vhdl << tab << declare("rm_" + X + "_q" + to_string(q), Q) << " <= (others => r_" << X << "_q" << q << ");" << endl;
+		vhdl << tab << declare("t_" + X, N) << " <= ax_" << X << " XOR (rm_" << X << "_q3 & rm_" << X << "_q2 & rm_" << X << "_q1 & rm_" << X << "_q0);" << endl;
+		// The sign is dropped, and a '1' at the LSB of each lane bounds its count to L-1
+		string u[3];
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			for(int l = (1 << m)-1; l >= 0; l--)
+				u[m] += "t_" + X + range(l*L+L-2, l*L) + " & '1'" + (l > 0 ? " & " : "");
+		}
+		modeMux("u_" + X, N, u[0], u[1], u[2]);
+		for(int q = 0; q < 4; q++) {
+			string lzq = "lzq_" + X + "_q" + to_string(q);
+			vhdl << tab << declare("uq_" + X + "_q" + to_string(q), Q) << " <= u_" << X << range(q*Q+Q-1, q*Q) << ";" << endl;
+			LZOC* lzc = (LZOC*) newInstance("LZOC", "LZOC_" + X + "_" + to_string(q), "wIn=" + to_string(Q), "I=>uq_" + X + "_q" + to_string(q) + ";OZB=>zero_ozb;O=>" + lzq);
+			syncCycleFromSignal(lzq);
+			setCriticalPath(lzc->getOutputDelay("O"));
+		}
+		int wZ = getSignalByName("lzq_" + X + "_q0")->width();
+		addComment("Lane counts, from the quarter counts");
+		for(int q = 0; q < 4; q++)
+			vhdl << tab << declare(ml("lz_" + X, 2, q), wA) << " <= " << (wA > wZ ? zg(wA-wZ) + " & " : "") << "lzq_" << X << "_q" << q << ";" << endl;
+		for(int h = 0; h < 2; h++)
+			vhdl << tab << declare(ml("lz_" + X, 1, h), wA) << " <= " << ml("lz_" + X, 2, 2*h) << " + " << Q << " when lzq_" << X << "_q" << 2*h+1 << " = " << Q
+				<< " else " << ml("lz_" + X, 2, 2*h+1) << ";" << endl;
+		vhdl << tab << declare(ml("lz_" + X, 0, 0), wA) << " <= " << ml("lz_" + X, 1, 0) << " + " << 2*Q << " when (lzq_" << X << "_q3 = " << Q << " and lzq_" << X << "_q2 = " << Q << ")"
+			<< " else " << ml("lz_" + X, 1, 1) << ";" << endl;
+		manageCriticalPath(getTarget()->localWireDelay() + getTarget()->adderDelay(wA));
+		broadcast("lz_" + X, wA);
+
+		addComment("Drop the sign and the first regime bit, then shift the remaining regime bits out");
+		string w[3];
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			for(int l = (1 << m)-1; l >= 0; l--)
+				w[m] += "ax_" + X + range(l*L+L-3, l*L) + " & \"00\"" + (l > 0 ? " & " : "");
+		}
+		modeMux("w_" + X, N, w[0], w[1], w[2]);
+		laneShifter("w_" + X, "lz_" + X, "ws_" + X, N, false);
+
+		addComment("Scale factors, and fractions left-aligned in their lanes with the hidden bit");
+		string f[3];
+		for(int m = 0; m < 3; m++) {
+			int L = N >> m;
+			int wK = intlog2(L-1)+1;
+			for(int l = (1 << m)-1; l >= 0; l--) {
+				int lo = l*L;
+				vhdl << tab << declare(ml("lzk_" + X, m, l), wK) << " <= ";
+				if(wK > wA)
+					vhdl << zg(wK-wA) << " & " << ml("lz_" + X, m, l) << ";" << endl;
+				else
+					vhdl << ml("lz_" + X, m, l) << range(wK-1, 0) << ";" << endl;
+				vhdl << tab << declare(ml("k_" + X, m, l), wK) << " <= " << ml("lzk_" + X, m, l) << " - 1 when " << ml("r_" + X, m, l) << " = '1' else"
+					<< " (NOT " << ml("lzk_" + X, m, l) << ") + 1;" << endl;
+				vhdl << tab << declare(ml("sf_" + X, m, l), wK+es) << " <= " << ml("k_" + X, m, l);
+				if (es>0)
+					vhdl << " & ws_" << X << range(lo+L-1, lo+L-es);
+				vhdl << ";" << endl;
+				vhdl << tab << declare(ml("nz_" + X, m, l)) << " <= NOT (" << ml("z_" + X, m, l) << " OR " << ml("inf_" + X, m, l) << ");" << endl;
+				f[m] += ml("nz_" + X, m, l) + " & ";
+				if(es == 0)
+					f[m] += "ws_" + X + range(lo+L-1, lo+1);
+				else
+					f[m] += "ws_" + X + range(lo+L-1-es, lo) + (es > 1 ? " & " + zg(es-1) : "");
+				f[m] += (l > 0 ? " & " : "");
+			}
+		}
+		manageCriticalPath(getTarget()->localWireDelay() + getTarget()->adderDelay(intlog2(N-1)+1));
+		modeMux("f_" + X, N, f[0], f[1], f[2]);
+	}
+
+
+	void PositMultSIMD::emulate(TestCase * tc) {
+		// get the inputs from the TestCase
+		mpz_class svX = tc->getInputValue ( "InputA" );
+		mpz_class svY = tc->getInputValue ( "InputB" );
+		mpz_class svM = tc->getInputValue ( "mode" );
+		const PositModel* models[3] = {&modelFull, &modelHalf, &modelQuarter};
+		// "11" is the 4 lane mode too
+		int m = (svM == 0 ? 0 : (svM == 1 ? 1 : 2));
+		int L = N >> m;
+		mpz_class mask = (mpz_class(1) << L) - 1;
+		mpz_class svR = 0;
+		for(int l = 0; l < (1 << m); l++) {
+			mpz_class a = (svX >> (l*L)) & mask;
+			mpz_class b = (svY >> (l*L)) & mask;
+			svR += models[m]->mult(a, b) << (l*L);
+		}
+		// complete the TestCase with this expected output
+		tc->addExpectedOutput ( "Output", svR );
+	}
+
+
+	TestCase* PositMultSIMD::buildRandomTestCase(int i) {
+		TestCase *tc = new TestCase(this);
+		tc->addInput("InputA", getLargeRandom(N));
+		tc->addInput("InputB", getLargeRandom(N));
+		tc->addInput("mode", mpz_class(i % 4));
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositMultSIMD::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		return new PositMultSIMD(target, N, es);
+	}
+
+
+	void PositMultSIMD::registerFactory(){
+		UserInterface::add("PositMultSIMD", // name
+											 "A posit multiplier computing one N-bit, two N/2-bit or four N/4-bit products.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=32: The datapath size, a multiple of 4; \
+                        					 es(int)=2: The exponent size of the posits, in every mode",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "The mode input selects 1xN (\"00\"), 2xN/2 (\"01\") or 4xN/4 (\"10\", or \"11\") lanes.",
+											 PositMultSIMD::parseArguments
+											 ) ;
+	}
+
+}//namespace
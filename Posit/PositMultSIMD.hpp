@@ -0,0 +1,112 @@
+/*
+  Lane-splittable posit multiplier.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MULT_SIMD_HPP
+#define POSIT_MULT_SIMD_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** One N-bit datapath computing, depending on the mode input, one N-bit,
+	    two N/2-bit or four N/4-bit posit products (mode "00", "01" and "10";
+	    "11" behaves as "10"). Lane l of each mode sits in bits l*L+L-1..l*L
+	    of the inputs and of the output, L being the lane width.
+	    The datapath is split in quarters: the negations and rounding increments
+	    are adders whose carries are killed at lane boundaries, the regime is
+	    counted by one LZOC per quarter, the shifters do not cross lane
+	    boundaries, and the fraction product is assembled from 16 quarter
+	    sub-products, of which the lanes only use the diagonal blocks.
+	    All the lanes share the same es. */
+	class PositMultSIMD : public Operator {
+	private:
+		/** The total width of the datapath */
+		int N;
+		/** The width of the exponent, in every mode */
+		int es;
+		/** The width of a quarter */
+		int Q;
+		/** Width of the shift amounts, enough to shift by N-1 */
+		int wA;
+
+		/** Software models of the 1, 2 and 4 lane modes, used by emulate */
+		PositModel modelFull;
+		PositModel modelHalf;
+		PositModel modelQuarter;
+
+		/** Name of the per-mode, per-lane signal base_m<m>_l<l> */
+		string ml(string base, int m, int l);
+
+		/** Selects the per-lane value seen by quarter q of a W-bit vector, according to the mode */
+		string laneOfQuarter(string base, int q);
+
+		/** Declares base_q<q>, the per-lane signal base seen by each quarter */
+		void broadcast(string base, int w);
+
+		/** Declares the W-bit signal r, one of three concatenations of lanes selected by the mode */
+		void modeMux(string r, int W, string e0, string e1, string e2);
+
+		/** Concatenation of the bits idx of signal x, MSB first, -1 standing for a '0' */
+		string bits(string x, vector<int> idx);
+
+		/** r = x + cin, per lane, cin being the broadcast one-bit signal cin_q<q> */
+		void laneIncrement(string x, string cin, string r);
+
+		/** Shifts the W-bit x per lane, by the broadcast amounts amt_q<q>.
+		    Left shifts insert zeros, right shifts replicate the MSB of each lane */
+		void laneShifter(string x, string amt, string r, int W, bool right);
+
+		/** Decodes InputX into the per-lane signals and the multiplier operand f_X */
+		void decode(string X);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the datapath, a multiple of 4.
+		    * @param es The width of the exponent.
+		    */
+		PositMultSIMD(Target* target, int N = 32, int es = 2, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositMultSIMD() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   The four values of mode are tested equally, "11" included */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,182 @@
+/* Exhaustive posit product table, cached on disk and memory-mapped */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "PositMultTable.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	/** Header of the cache file, padded so that the entries are aligned */
+	struct PositMultTableHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t N;
+		uint32_t es;
+		uint32_t entryBytes;
+		uint64_t entries;
+		/** PositModel::version of the model the table was built from */
+		uint32_t modelVersion;
+		char padding[28];
+	};
+
+	static const char tableMagic[8] = {'P','O','S','I','T','T','B','L'};
+	static const uint32_t tableVersion = 2;
+
+
+	PositMultTable::PositMultTable(int N, int es, string fileName) :
+	N(N), es(es), mapping(NULL), mappingSize(0), data(NULL) {
+		if(N < 3 || N > 16) {
+			ostringstream o;
+			o << "PositMultTable: exhaustive tables are limited to 3 <= N <= 16, got N=" << N;
+			throw o.str();
+		}
+		mask = (((uint64_t)1) << N) - 1;
+		narBits = ((uint64_t)1) << (N-1);
+		entries = index(narBits-1, narBits-1) + 1;
+		entryBytes = (N <= 8 ? 1 : 2);
+
+		if(fileName == "")
+			fileName = defaultFileName(N, es);
+		if(!load(fileName)) {
+			build(fileName);
+			if(!load(fileName)) {
+				ostringstream o;
+				o << "PositMultTable: unable to map " << fileName;
+				throw o.str();
+			}
+		}
+	}
+
+
+	PositMultTable::~PositMultTable() {
+		if(mapping != NULL)
+			munmap(mapping, mappingSize);
+	}
+
+
+	string PositMultTable::defaultFileName(int N, int es) {
+		ostringstream name;
+		name << "PositMult_" << N << "_" << es << ".tbl";
+		return name.str();
+	}
+
+
+	bool PositMultTable::load(string fileName) {
+		int fd = open(fileName.c_str(), O_RDONLY);
+		if(fd < 0)
+			return false;
+
+		struct stat st;
+		size_t expected = sizeof(PositMultTableHeader) + entries*entryBytes;
+		if(fstat(fd, &st) != 0 || (size_t)st.st_size != expected) {
+			close(fd);
+			return false;
+		}
+		void* m = mmap(NULL, expected, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if(m == MAP_FAILED)
+			return false;
+
+		const PositMultTableHeader* h = (const PositMultTableHeader*) m;
+		if(memcmp(h->magic, tableMagic, 8) != 0 || h->version != tableVersion
+			 || (int)h->N != N || (int)h->es != es
+			 || (int)h->entryBytes != entryBytes || h->entries != entries
+			 || h->modelVersion != PositModel::version) {
+			munmap(m, expected);
+			return false;
+		}
+		mapping = m;
+		mappingSize = expected;
+		data = (const char*)m + sizeof(PositMultTableHeader);
+		if(!matchesModel()) {
+			munmap(mapping, mappingSize);
+			mapping = NULL;
+			mappingSize = 0;
+			data = NULL;
+			return false;
+		}
+		return true;
+	}
+
+
+	bool PositMultTable::matchesModel() const {
+		PositModel model(N, es);
+		// The rows of the powers of two and of maxpos: the longest regimes and exponents cut by the regime
+		vector<uint64_t> rows;
+		for(int j = 0; j < N-1; j++)
+			rows.push_back(((uint64_t)1) << j);
+		rows.push_back(narBits-1);
+		for(uint64_t i : rows)
+			for(uint64_t j = 0; j < narBits; j++)
+				if(mult(i, j) != model.mult(i, j))
+					return false;
+		// and pseudo-random entries
+		uint64_t z = 0;
+		for(int k = 0; k < 65536; k++) {
+			z = z * 6364136223846793005ULL + 1442695040888963407ULL;
+			uint64_t i = (z >> 32) & mask;
+			uint64_t j = (z >> 11) & mask;
+			if(mult(i, j) != model.mult(i, j))
+				return false;
+		}
+		return true;
+	}
+
+
+	void PositMultTable::build(string fileName) {
+		// Write to a temporary file first so that an interrupted run never leaves a truncated table behind
+		string tmpName = fileName + ".tmp";
+		FILE* f = fopen(tmpName.c_str(), "wb");
+		if(f == NULL) {
+			ostringstream o;
+			o << "PositMultTable: unable to create " << tmpName;
+			throw o.str();
+		}
+
+		PositMultTableHeader h;
+		memset(&h, 0, sizeof(h));
+		memcpy(h.magic, tableMagic, 8);
+		h.version = tableVersion;
+		h.N = N;
+		h.es = es;
+		h.entryBytes = entryBytes;
+		h.entries = entries;
+		h.modelVersion = PositModel::version;
+		bool ok = (fwrite(&h, sizeof(h), 1, f) == 1);
+
+		// One row of the triangle at a time: row i holds the products i*j, j <= i
+		PositModel model(N, es);
+		vector<uint8_t> row8;
+		vector<uint16_t> row16;
+		for(uint64_t i=0; ok && i<narBits; i++) {
+			if(entryBytes == 1) {
+				row8.resize(i+1);
+				for(uint64_t j=0; j<=i; j++)
+					row8[j] = (uint8_t) model.mult(i, j);
+				ok = (fwrite(&row8[0], 1, i+1, f) == i+1);
+			}
+			else {
+				row16.resize(i+1);
+				for(uint64_t j=0; j<=i; j++)
+					row16[j] = (uint16_t) model.mult(i, j);
+				ok = (fwrite(&row16[0], 2, i+1, f) == i+1);
+			}
+		}
+		ok = (fclose(f) == 0) && ok;
+		if(!ok || rename(tmpName.c_str(), fileName.c_str()) != 0) {
+			remove(tmpName.c_str());
+			ostringstream o;
+			o << "PositMultTable: unable to write " << fileName;
+			throw o.str();
+		}
+	}
+
+}//namespace
@@ -0,0 +1,100 @@
+/*
+  Exhaustive posit product table.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_MULT_TABLE_HPP
+#define POSIT_MULT_TABLE_HPP
+
+#include <string>
+#include <stdint.h>
+
+#include "PositModel.hpp"
+
+
+namespace flopoco {
+
+	/** Precomputed table of all the products of posit<N,es>, N <= 16.
+	    The table is filled once from PositModel and cached on disk in a file
+	    keyed by (N, es), which is then memory-mapped by later runs.
+	    Only magnitudes are stored (the product is odd in each operand), and only
+	    for |a| >= |b| (the product is commutative), so posit16 takes 1GB.
+	    The file records PositModel::version, and a sample of its entries is
+	    checked against the model when it is loaded: a table left by an older model
+	    is built again. */
+	class PositMultTable {
+	public:
+		/** The constructor. Loads the table from fileName, building it first if needed
+		    * @param N The size of the posits, at most 16.
+		    * @param es The width of the exponent.
+		    * @param fileName The cache file, defaultFileName(N, es) if empty.
+		    */
+		PositMultTable(int N, int es, std::string fileName = "");
+
+		~PositMultTable();
+
+		/** Posit product by table lookup */
+		uint64_t mult(uint64_t a, uint64_t b) const {
+			a &= mask;
+			b &= mask;
+			if(a == narBits || b == narBits)
+				return narBits;
+			bool sign = ((a ^ b) & narBits) != 0;
+			if(a & narBits)
+				a = (-a) & mask;
+			if(b & narBits)
+				b = (-b) & mask;
+			uint64_t r = (a >= b ? entry(a, b) : entry(b, a));
+			return (sign ? (-r) & mask : r);
+		}
+
+		/** The name of the cache file of posit<N,es> */
+		static std::string defaultFileName(int N, int es);
+
+		/** The input pairs of an exhaustive sweep, enumerated by parts of sweepPartSize
+		    pairs: the test count of TestBench is an int, and posit16 has 2^32 pairs */
+		static const uint64_t sweepPartSize = ((uint64_t)1) << 30;
+		/** The number of parts sweeping the 2^(2N) input pairs */
+		static int sweepParts(int N) {return (2*N > 30 ? 1 << (2*N-30) : 1);}
+
+		int N;
+		int es;
+
+	private:
+		/** Index of the magnitudes i >= j in the triangular table */
+		static uint64_t index(uint64_t i, uint64_t j) {return i*(i+1)/2 + j;}
+
+		uint64_t entry(uint64_t i, uint64_t j) const {
+			return (entryBytes == 1 ? ((const uint8_t*)data)[index(i, j)] : ((const uint16_t*)data)[index(i, j)]);
+		}
+
+		/** Map the cache file, returns false if it is missing, does not match (N, es),
+		    or was built by another version of PositModel */
+		bool load(std::string fileName);
+		/** true when a sample of the entries, the longest regimes included, are the products of the current PositModel */
+		bool matchesModel() const;
+		/** Fill the table with the model and write it to fileName */
+		void build(std::string fileName);
+
+		uint64_t mask;
+		uint64_t narBits;
+		/** Number of entries, 2^(N-1)*(2^(N-1)+1)/2 */
+		uint64_t entries;
+		/** Bytes per entry, 1 up to posit8 and 2 above */
+		int entryBytes;
+
+		void* mapping;
+		size_t mappingSize;
+		const void* data;
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,209 @@
+/* Generation-time cost report of the posit operators.
+   The LUT and DSP counts are rough estimates from the widths of the logic,
+   for comparing configurations without a synthesis run */
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <math.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+
+#include "PositReport.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositReport::PositReport() : lastCycle(0) {
+	}
+
+
+	void PositReport::add(Stage s, int innerDepth) {
+		// the signals left in flight by the previous stage cross the boundaries since then,
+		// except those inside a sub-component, counted by it
+		int boundaries = s.cycle - lastCycle - innerDepth;
+		if(boundaries > 0 && !stages.empty())
+			s.registers += stages.back().width * boundaries;
+		// a stage placed on a parallel branch, earlier than the last one, does not move the count back
+		if(s.cycle > lastCycle)
+			lastCycle = s.cycle;
+		stages.push_back(s);
+	}
+
+
+	void PositReport::stage(Operator* op, string name, int luts, const vector<string>& inFlight) {
+		Stage s;
+		s.name = name;
+		s.cycle = op->getCurrentCycle();
+		s.delay = op->getCriticalPath();
+		s.luts = luts;
+		s.dsps = 0;
+		s.registers = 0;
+		s.width = width(op, inFlight);
+		add(s, 0);
+	}
+
+
+	void PositReport::component(Operator* op, string name, Operator* sub, int luts, int dsps, const vector<string>& inFlight) {
+		Stage s;
+		s.name = name;
+		s.component = sub->getName();
+		s.cycle = op->getCurrentCycle();
+		s.delay = op->getCriticalPath();
+		s.luts = luts;
+		s.dsps = dsps;
+		s.width = width(op, inFlight);
+		s.registers = sub->getPipelineDepth() * s.width;
+		add(s, sub->getPipelineDepth());
+	}
+
+
+	void PositReport::component(Operator* op, string name, string type, const PositReport& sub, const vector<string>& inFlight) {
+		Stage s;
+		s.name = name;
+		s.component = type;
+		s.cycle = op->getCurrentCycle();
+		s.delay = op->getCriticalPath();
+		s.luts = sub.luts();
+		s.dsps = sub.dsps();
+		s.registers = sub.registers();
+		s.width = width(op, inFlight);
+		s.stages = sub.stages;
+		add(s, sub.depth());
+	}
+
+
+	int PositReport::width(Operator* op, const vector<string>& signals) {
+		int w = 0;
+		for(const string& name : signals)
+			w += op->getSignalByName(name)->width();
+		return w;
+	}
+
+
+	int PositReport::luts() const {
+		int n = 0;
+		for(const Stage& s : stages)
+			n += s.luts;
+		return n;
+	}
+
+
+	int PositReport::dsps() const {
+		int n = 0;
+		for(const Stage& s : stages)
+			n += s.dsps;
+		return n;
+	}
+
+
+	int PositReport::registers() const {
+		int n = 0;
+		for(const Stage& s : stages)
+			n += s.registers;
+		return n;
+	}
+
+
+	int PositReport::depth() const {
+		return lastCycle;
+	}
+
+
+	double PositReport::criticalPath() const {
+		double d = 0;
+		for(const Stage& s : stages) {
+			if(s.delay > d)
+				d = s.delay;
+			for(const Stage& t : s.stages)
+				if(t.delay > d)
+					d = t.delay;
+		}
+		return d;
+	}
+
+
+	void PositReport::writeStages(const vector<Stage>& stages, ostream& o, string indent) {
+		o << "[";
+		for(size_t i = 0; i < stages.size(); i++) {
+			const Stage& s = stages[i];
+			o << (i ? "," : "") << endl << indent << "  {\"name\": \"" << s.name << "\"";
+			if(!s.component.empty())
+				o << ", \"component\": \"" << s.component << "\"";
+			o << ", \"cycle\": " << s.cycle << ", \"delay_ns\": " << s.delay*1e9
+				<< ", \"luts\": " << s.luts << ", \"dsps\": " << s.dsps << ", \"registers\": " << s.registers;
+			if(!s.stages.empty()) {
+				o << ", \"stages\": ";
+				writeStages(s.stages, o, indent + "  ");
+			}
+			o << "}";
+		}
+		o << endl << indent << "]";
+	}
+
+
+	void PositReport::write(Operator* op, ostream& o) const {
+		Target* target = op->getTarget();
+		o << "{" << endl;
+		o << "  \"operator\": \"" << op->getName() << "\"," << endl;
+		o << "  \"target\": \"" << target->getID() << "\"," << endl;
+		o << "  \"frequency_mhz\": " << target->frequency()/1e6 << "," << endl;
+		o << "  \"pipeline_depth\": " << depth() << "," << endl;
+		o << "  \"critical_path_ns\": " << criticalPath()*1e9 << "," << endl;
+		o << "  \"luts\": " << luts() << "," << endl;
+		o << "  \"dsps\": " << dsps() << "," << endl;
+		o << "  \"registers\": " << registers() << "," << endl;
+		o << "  \"stages\": ";
+		writeStages(stages, o, "  ");
+		o << endl << "}" << endl;
+	}
+
+
+	void PositReport::write(Operator* op) const {
+		ofstream f(op->getName() + ".json");
+		write(op, f);
+	}
+
+
+	int PositReport::lzocLuts(int wIn) {
+		// a tree of OR gates and multiplexers, about two LUTs per input bit
+		return 2*wIn;
+	}
+
+
+	int PositReport::shifterLuts(Target* target, int wIn, int maxShift) {
+		// one LUT per output bit and per level of 4:1 multiplexers (2:1 with 4-input LUTs)
+		int levels = intlog2(maxShift);
+		int perLut = (target->lutInputs() >= 6 ? 2 : 1);
+		return (wIn+maxShift) * ((levels+perLut-1) / perLut);
+	}
+
+
+	int PositReport::comparatorLuts(Target* target, int w) {
+		int k = target->lutInputs();
+		return (w + k-2) / (k-1);
+	}
+
+
+	void PositReport::multiplierCost(Target* target, int wX, int wY, int wOut, int& luts, int& dsps) {
+		// a truncated product needs about half of the tiles or partial products
+		bool truncated = (wOut > 0 && wOut < wX+wY);
+		if(target->hasHardMultipliers()) {
+			int tx = (wX + target->multXInputs()-1) / target->multXInputs();
+			int ty = (wY + target->multYInputs()-1) / target->multYInputs();
+			dsps = tx*ty;
+			if(truncated)
+				dsps = (dsps+1) / 2;
+			// the tiles are summed by adders as wide as the product
+			luts = (dsps-1) * (wX+wY);
+		}
+		else {
+			dsps = 0;
+			luts = wX*wY/2;
+			if(truncated)
+				luts /= 2;
+		}
+	}
+
+}//namespace
@@ -0,0 +1,108 @@
+/*
+  Generation-time cost report of the posit operators.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_REPORT_HPP
+#define POSIT_REPORT_HPP
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The estimated cost of an operator, recorded stage by stage as its
+	    constructor places the logic, and written as JSON.
+	    Each stage is the logic following a manageCriticalPath or a
+	    sub-component: its cycle, the critical path after it, and rough LUT and
+	    DSP counts. The registers are estimated from the width each stage
+	    leaves in flight, times the number of cycle boundaries it crosses, plus
+	    the registers inside the sub-components.
+	    These are estimates for comparing configurations without synthesis. */
+	class PositReport {
+	public:
+		/** One stage, or one sub-component with its own stages */
+		struct Stage {
+			string name;
+			/** The FloPoCo operator of a sub-component, empty for local logic */
+			string component;
+			int cycle;
+			/** Critical path at the end of the stage, in seconds */
+			double delay;
+			int luts;
+			int dsps;
+			int registers;
+			/** Width of the signals in flight after the stage */
+			int width;
+			vector<Stage> stages;
+		};
+
+		PositReport();
+
+		/** Record the logic placed since the last record
+		    * @param op The operator being built, at the end of the stage.
+		    * @param name A short description of the logic.
+		    * @param luts Its estimated LUT count.
+		    * @param inFlight The signals of op in flight after it, whose widths give the registers.
+		    */
+		void stage(Operator* op, string name, int luts, const vector<string>& inFlight);
+
+		/** Record a FloPoCo sub-component, after the sync on its outputs
+		    * @param sub The sub-component, as returned by newInstance.
+		    * @param dsps Its estimated DSP count.
+		    */
+		void component(Operator* op, string name, Operator* sub, int luts, int dsps, const vector<string>& inFlight);
+
+		/** Record a posit sub-component, with the stages of its own report */
+		void component(Operator* op, string name, string type, const PositReport& sub, const vector<string>& inFlight);
+
+		int luts() const;
+		int dsps() const;
+		int registers() const;
+		/** The cycle of the last stage */
+		int depth() const;
+		/** The longest critical path of a stage, in seconds */
+		double criticalPath() const;
+
+		/** Write the report of operator op as JSON */
+		void write(Operator* op, ostream& o) const;
+		/** Write it to <name of op>.json */
+		void write(Operator* op) const;
+
+		/** Rough LUT counts of the FloPoCo sub-components */
+		static int lzocLuts(int wIn);
+		static int shifterLuts(Target* target, int wIn, int maxShift);
+		static int comparatorLuts(Target* target, int w);
+		/** LUTs and DSPs of a wX x wY IntMultiplier (wOut = 0 for the full product) */
+		static void multiplierCost(Target* target, int wX, int wY, int wOut, int& luts, int& dsps);
+
+	private:
+		vector<Stage> stages;
+		/** Cycle of the last record, for the register count */
+		int lastCycle;
+
+		/** The total width of signals of op */
+		static int width(Operator* op, const vector<string>& signals);
+		/** Append s, innerDepth being the cycles inside it */
+		void add(Stage s, int innerDepth);
+		static void writeStages(const vector<Stage>& stages, ostream& o, string indent);
+	};
+
+}//namespace
+
+
+#endif
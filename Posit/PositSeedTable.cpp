@@ -0,0 +1,82 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <gmp.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+
+// include the header of the Operator
+#include "PositSeedTable.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositSeedTable::PositSeedTable(Target* target, int wIn, int wOut, bool sqrt) :
+	Table(target, wIn, wOut), sqrt(sqrt) {
+
+		srcFileName="PositSeedTable";
+
+		// The entries are computed in double precision
+		if(wOut > 40)
+			THROWERROR("the output is limited to 40 bits, got wOut=" << wOut);
+		if(sqrt && wIn < 2)
+			THROWERROR("the index of the inverse square root includes two integer bits, wIn must be at least 2, got wIn=" << wIn);
+
+		ostringstream name;
+		name << "PositSeedTable_" << (sqrt ? "rsqrt_" : "recip_") << wIn << "_" << wOut;
+		setNameWithFreqAndUID(name.str());
+		setCopyrightString("Raul Murillo, 2019");
+	};
+
+
+	mpz_class PositSeedTable::function(int x) {
+		double one = ldexp(1.0, wOut-1);
+		double y;
+		if(sqrt) {
+			// m in [1,4) has wIn-2 fraction bits in the index
+			if(x < (1 << (wIn-2)))
+				return mpz_class((unsigned long) one);
+			double m = ldexp(x + 0.5, -(wIn-2));
+			y = one / ::sqrt(m);
+		}
+		else {
+			double d = 1.0 + ldexp(x + 0.5, -wIn);
+			y = one / d;
+		}
+		return mpz_class((unsigned long) floor(y + 0.5));
+	}
+
+
+	OperatorPtr PositSeedTable::parseArguments(Target *target, vector<string> &args) {
+		int wIn;
+		UserInterface::parseStrictlyPositiveInt(args, "wIn", &wIn);
+		int wOut;
+		UserInterface::parseStrictlyPositiveInt(args, "wOut", &wOut);
+		bool sqrt;
+		UserInterface::parseBoolean(args, "sqrt", &sqrt);
+		return new PositSeedTable(target, wIn, wOut, sqrt);
+	}
+
+
+	void PositSeedTable::registerFactory(){
+		UserInterface::add("PositSeedTable", // name
+											 "The seed of the Newton-Raphson iterations of PositDiv and PositSqrt.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositDiv, PositSqrt", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "wIn(int)=8: The index width; \
+                        					 wOut(int)=10: The output width, one integer bit included; \
+                        					 sqrt(bool)=false: The inverse square root instead of the reciprocal",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Usually instantiated by PositDiv arch=1 and PositSqrt arch=1.",
+											 PositSeedTable::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,62 @@
+/*
+  Seed tables of the Newton-Raphson iterations of PositDiv and PositSqrt.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_SEED_TABLE_HPP
+#define POSIT_SEED_TABLE_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "../Table.hpp"
+
+
+namespace flopoco {
+
+	/** An approximation of 1/d or 1/sqrt(m), indexed by the leading bits of d or m.
+	    For the reciprocal, X is the wIn fraction bits after the hidden bit of d in [1,2).
+	    For the inverse square root, X is the wIn leading bits of m in [1,4), two of them
+	    integer bits; the entries with m < 1 are never read.
+	    Y, in (0.5,1], has one integer bit and wOut-1 fraction bits, rounded from the
+	    value at the middle of the interval: its error is below 2^-(wIn+1) + 2^-wOut
+	    for the reciprocal, 2^-wIn + 2^-wOut for the inverse square root. */
+	class PositSeedTable : public Table {
+	private:
+		/** true for 1/sqrt(m), false for 1/d */
+		bool sqrt;
+
+	public:
+		/** The constructor
+		    * @param wIn The index width.
+		    * @param wOut The output width, one integer bit included.
+		    * @param sqrt true for the inverse square root.
+		    */
+		PositSeedTable(Target* target, int wIn = 8, int wOut = 10, bool sqrt = false);
+
+		// destructor
+		~PositSeedTable() {};
+
+		/** The content of the table */
+		mpz_class function(int x);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
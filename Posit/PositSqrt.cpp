@@ -0,0 +1,225 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+#include "PositSeedTable.hpp"
+
+// include the header of the Operator
+#include "PositSqrt.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositSqrt::PositSqrt(Target* target, int N, int es, int arch, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), arch(arch), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositSqrt";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositSqrt_" << N << "_" << es;
+		if(arch == 1)
+			name << "_nr";
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+		// The fraction bits after the hidden bit
+		int F = FracSize-1;
+		// The root bits after the point: the N-es-3 fraction bits a posit may keep, the guard and the round bits
+		int P = N-es-1;
+
+		if(arch < 0 || arch > 1)
+			THROWERROR("arch must be 0 or 1");
+		if(arch == 1 && F < 1)
+			THROWERROR("arch=1 indexes its seed table with the fraction of Input, it needs N >= es+4");
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Input", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositSqrt \n");
+		REPORT(DETAILED, "this operator has received three parameters " << N << ", " << es << " and " << arch);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		PositDecoder* decoder = (PositDecoder*) newInstance("PositDecoder", "decoder", "N=" + to_string(N) + " es=" + to_string(es), "Input=>Input;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z_A;inf=>inf_A");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoder->getOutputDelay("Reg"));
+
+		addComment("Gather scale factor");
+		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+		if (es>0) vhdl << " & exp_A";
+		vhdl << ";" << endl;
+
+	//=========================================================================|
+		addFullComment("Sign and Special Cases Computation");
+	// ========================================================================|
+
+		vhdl << tab << declare("sign") << " <= '0';" << endl;
+		addComment("The root of a negative posit is NaR");
+		vhdl << tab << declare("z") << " <= z_A;" << endl;
+		vhdl << tab << declare("inf") << " <= inf_A OR (sign_A AND NOT z_A);" << endl;
+
+	//=========================================================================|
+		addFullComment("Halve the scale factor, square root of the fraction");
+	// ========================================================================|
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("An odd scale factor moves one bit into the fraction m, in [1,4)");
+		vhdl << tab << declare("m", F+2) << " <= frac_A & '0' when sf_A(0) = '1' else '0' & frac_A;" << endl;
+		vhdl << tab << declare("sf_sqrt", RegSize+es) << " <= sf_A(sf_A'high) & sf_A" << range(RegSize+es-1, 1) << ";" << endl;
+		addComment("The radicand m*2^(2P), whose integer root has P bits after the point");
+		vhdl << tab << declare("rad", 2*P+2) << " <= m & " << zg(2*P-F) << ";" << endl;
+
+		if(arch == 0) {
+			addComment("Restoring square root, one root bit per step: the partial remainder stays below 2*root+1");
+			for(int i = 0; i <= P; i++) {
+				string sh = "sh_" + to_string(i);
+				string d = "diff_" + to_string(i);
+				string s = "s_" + to_string(i);
+				manageCriticalPath(target->localWireDelay() + target->adderDelay(i+4) + target->lutDelay());
+				vhdl << tab << declare(sh, i+3) << " <= " << (i == 0 ? "'0'" : "rem_" + to_string(i))
+												<< " & rad" << range(2*P+1-2*i, 2*P-2*i) << ";" << endl;
+				vhdl << tab << declare(d, i+4) << " <= ('0' & " << sh << ") - (\"00\" & "
+												<< (i == 0 ? "" : "root_" + to_string(i) + " & ") << "\"01\");" << endl;
+				vhdl << tab << declare(s) << " <= not " << d << of(i+3) << ";" << endl;
+				vhdl << tab << declare("rem_" + to_string(i+1), i+2) << " <= " << d << range(i+1, 0) << " when " << s << " = '1' else "
+												<< sh << range(i+1, 0) << ";" << endl;
+				vhdl << tab << declare("root_" + to_string(i+1), i+1) << " <= " << (i == 0 ? "" : "root_" + to_string(i) + " & ") << s << ";" << endl;
+			}
+			vhdl << tab << declare("root", P+1) << " <= root_" << P+1 << ";" << endl;
+			vhdl << tab << declare("sticky") << " <= '0' when rem_" << P+1 << " = 0 else '1';" << endl;
+		}
+		else {
+			// The seed is indexed by the t leading bits of m, two of them integer bits, and has t+2 fraction bits
+			int t = min(F+2, 11);
+			int wS = t+2;
+			// y has wY fraction bits: the root estimate below needs an error of 1/sqrt(m) under 2^-(P+3)
+			int wY = P+7;
+			// The error of y_{k+1} is below 4*e_k^2, plus those of the four truncated products
+			double err = ldexp(1.0, -t) + ldexp(1.0, -(wS+1));
+			int iterations = 0;
+			while(err >= ldexp(1.0, -(P+3))) {
+				err = 4*err*err + ldexp(1.0, 2-wY);
+				iterations++;
+			}
+			REPORT(DETAILED, "Seed table of " << t << " input bits, " << iterations << " Newton-Raphson iterations");
+
+			vhdl << tab << declare("seed_idx", t) << " <= m" << range(F+1, F+2-t) << ";" << endl;
+			PositSeedTable* seed = (PositSeedTable*) newInstance("PositSeedTable", "seed_table", "wIn=" + to_string(t) + " wOut=" + to_string(wS+1) + " sqrt=true", "X=>seed_idx;Y=>seed");
+			syncCycleFromSignal("seed");
+			setCriticalPath(seed->getOutputDelay("Y"));
+			vhdl << tab << declare("y_0", wY+1) << " <= seed & " << zg(wY-wS) << ";" << endl;
+
+			for(int k = 0; k < iterations; k++) {
+				string y = "y_" + to_string(k);
+				string k1 = to_string(k+1);
+				addComment("y_" + k1 + " = y_" + to_string(k) + "*(3 - m*y_" + to_string(k) + "^2)/2");
+				multiply(y, wY+1, y, wY+1, wY+2, "yy_" + k1);
+				multiply("m", F+2, "yy_" + k1, wY+2, wY+4, "myy_" + k1);
+				manageCriticalPath(target->localWireDelay() + target->adderDelay(wY+4));
+				vhdl << tab << declare("e_" + k1, wY+4) << " <= \"" << unsignedBinary(mpz_class(3) << wY, wY+4) << "\" - myy_" << k1 << ";" << endl;
+				multiply(y, wY+1, "e_" + k1, wY+4, wY+4, "ye_" + k1);
+				vhdl << tab << declare("y_" + k1, wY+1) << " <= ye_" << k1 << range(wY, 0) << ";" << endl;
+			}
+
+			addComment("Root estimate with two more bits, truncated: within one of the truncated root");
+			multiply("m", F+2, "y_" + to_string(iterations), wY+1, P+5, "my");
+			vhdl << tab << declare("root_a", P+1) << " <= my" << range(P+2, 2) << ";" << endl;
+
+			addComment("The remainder rad - root_a^2 is within (-2*root_a,4*root_a): its P+4 low bits are enough");
+			multiply("root_a", P+1, "root_a", P+1, 0, "ss");
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(P+4));
+			vhdl << tab << declare("rem_a", P+4) << " <= rad" << range(P+3, 0) << " - ss" << range(P+3, 0) << ";" << endl;
+
+			addComment("Correct the root by one ulp");
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(P+4));
+			vhdl << tab << declare("rem_m", P+4) << " <= rem_a - (\"00\" & root_a & '1');" << endl;
+			vhdl << tab << declare("rem_p", P+4) << " <= rem_a + (\"00\" & root_a & '0') - 1;" << endl;
+			vhdl << tab << declare("root_dec") << " <= rem_a" << of(P+3) << ";" << endl;
+			vhdl << tab << declare("root_inc") << " <= not rem_a" << of(P+3) << " and not rem_m" << of(P+3) << ";" << endl;
+			manageCriticalPath(target->localWireDelay() + target->adderDelay(P+1) + target->lutDelay());
+			vhdl << tab << declare("root", P+1) << " <= root_a - 1 when root_dec = '1' else"
+											<< " root_a + 1 when root_inc = '1' else root_a;" << endl;
+			vhdl << tab << declare("rem_c", P+4) << " <= rem_p when root_dec = '1' else"
+											<< " rem_m when root_inc = '1' else rem_a;" << endl;
+			vhdl << tab << declare("sticky") << " <= '0' when rem_c = 0 else '1';" << endl;
+		}
+
+		addComment("The root is in [1,2), the sticky bit below");
+		vhdl << tab << declare("normFrac", P+2) << " <= root & sticky;" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(RegSize+es) + " wF=" + to_string(P+2), "Sign=>sign;SF=>sf_sqrt;Frac=>normFrac;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	void PositSqrt::multiply(string x, int wX, string y, int wY, int wOut, string r) {
+		IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", r + "_mult", "wX=" + to_string(wX) + " wY=" + to_string(wY) + " wOut=" + to_string(wOut), "X=>" + x + ";Y=>" + y + ";R=>" + r);
+		syncCycleFromSignal(r);
+		setCriticalPath(mult->getOutputDelay("R"));
+	}
+
+
+	void PositSqrt::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "Input" );
+		tc->addExpectedOutput ( "Output", model.sqrt(svX) );
+	}
+
+
+	OperatorPtr PositSqrt::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		int arch;
+		UserInterface::parsePositiveInt(args, "arch", &arch);
+		return new PositSqrt(target, N, es, arch);
+	}
+
+
+	void PositSqrt::registerFactory(){
+		UserInterface::add("PositSqrt", // name
+											 "A posit square root, with a digit-recurrence and a Newton-Raphson architecture.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositDiv, PositSquare", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size; \
+                        					 arch(int)=0: 0 for a restoring digit recurrence with one adder per root bit, 1 for Newton-Raphson iterations on IntMultiplier from a seed table",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even. The root of a negative posit is NaR.",
+											 PositSqrt::parseArguments
+											 ) ;
+	}
+
+}//namespace
@@ -0,0 +1,85 @@
+/*
+  Posit square root.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_SQRT_HPP
+#define POSIT_SQRT_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The square root of an N-bit posit, correctly rounded.
+	    With an even scale factor 2*s, the fraction m is in [1,4) and the root is
+	    sqrt(m)*2^s: the scale factor is halved by a shift, and the root of m is
+	    computed with N-es-1 bits after the point and a sticky bit, then rounded
+	    by PositEncoder. A negative input gives NaR.
+	    Two architectures, both pipelined to one square root per cycle:
+	    arch 0 is a restoring digit recurrence, one root bit and one adder per step;
+	    arch 1 computes 1/sqrt(m) by Newton-Raphson iterations from a seed table,
+	    multiplies it by m, and corrects the root by one ulp from its remainder. */
+	class PositSqrt : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** 0 for the digit recurrence, 1 for Newton-Raphson */
+		int arch;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** Declares r, the product of x of wX bits by y of wY bits, truncated to its wOut leading bits (0 for all) */
+		void multiply(string x, int wX, string y, int wY, int wOut, string r);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param arch The architecture, 0 for the digit recurrence, 1 for Newton-Raphson.
+		    */
+		PositSqrt(Target* target, int N = 8, int es = 1, int arch = 0, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositSqrt() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
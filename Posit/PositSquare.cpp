@@ -0,0 +1,154 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositSquare.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositSquare::PositSquare(Target* target, int N, int es, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositSquare";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositSquare_" << N << "_" << es;
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		RegSize = intlog2(N-1)+1;
+		FracSize = N-es-2;
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "Input", N);
+		addOutput ( "Output", N);
+
+		setCriticalPath( getMaxInputDelays(inputDelays) );
+
+		REPORT(INFO,"Declaration of PositSquare \n");
+		REPORT(DETAILED, "this operator has received two parameters " << N << " and " << es);
+
+	//=========================================================================|
+		addFullComment("Data Extraction");
+	// ========================================================================|
+		PositDecoder* decoder = (PositDecoder*) newInstance("PositDecoder", "decoder", "N=" + to_string(N) + " es=" + to_string(es), "Input=>Input;Sign=>sign_A;Reg=>reg_A;Exp=>exp_A;Frac=>frac_A;z=>z;inf=>inf");
+		syncCycleFromSignal("reg_A");
+		setCriticalPath(decoder->getOutputDelay("Reg"));
+
+		addComment("Gather scale factor");
+		vhdl << tab << declare("sf_A", RegSize+es) << " <= reg_A";
+		if (es>0) vhdl << " & exp_A";
+		vhdl << ";" << endl;
+		addComment("A square is never negative");
+		vhdl << tab << declare("sign") << " <= '0';" << endl;
+
+	//=========================================================================|
+		addFullComment("Square the fraction, double the exponent value");
+	// ========================================================================|
+		square("frac_A", FracSize, "frac_sq");
+		int sq_size = 2*FracSize;
+
+		manageCriticalPath(target->localWireDelay() + target->lutDelay());
+		addComment("Adjust for overflow");
+		vhdl << tab << declare("ovf_m") << " <= frac_sq(frac_sq'high);" << endl;
+		vhdl << tab << declare("normFrac", sq_size) << " <= frac_sq" << range(sq_size-2, 0) << " & '0' when ovf_m = '0' else"
+												<< " frac_sq;" << endl;
+		addComment("2*sf + ovf_m: the LSB of 2*sf is free for ovf_m");
+		vhdl << tab << declare("sf_sq", RegSize+es+1) << " <= sf_A & ovf_m;" << endl;
+
+	//=========================================================================|
+		addFullComment("Rounding and Packing");
+	// ========================================================================|
+		PositEncoder* encoder = (PositEncoder*) newInstance("PositEncoder", "encoder", "N=" + to_string(N) + " es=" + to_string(es) + " wSF=" + to_string(RegSize+es+1) + " wF=" + to_string(sq_size), "Sign=>sign;SF=>sf_sq;Frac=>normFrac;z=>z;inf=>inf;Output=>posit_out");
+		syncCycleFromSignal("posit_out");
+		setCriticalPath(encoder->getOutputDelay("Output"));
+
+		vhdl << tab << "Output <= posit_out;" << endl;
+	};
+
+
+	void PositSquare::square(string x, int w, string r) {
+		// Below 16 bits a single multiplier is kept: the halves would be smaller than the multiplier blocks
+		if(w < 16) {
+			IntMultiplier* mult = (IntMultiplier*) newInstance("IntMultiplier", r + "_mult", "wX=" + to_string(w) + " wY=" + to_string(w) + " wOut=0", "X=>" + x + ";Y=>" + x + ";R=>" + r);
+			syncCycleFromSignal(r);
+			setCriticalPath(mult->getOutputDelay("R"));
+			return;
+		}
+		int h = w/2;
+		vhdl << tab << declare(x + "_h", w-h) << " <= " << x << range(w-1, h) << ";" << endl;
+		vhdl << tab << declare(x + "_l", h) << " <= " << x << range(h-1, 0) << ";" << endl;
+
+		// The three products are computed in parallel
+		double cpIn = getCriticalPath();
+		square(x + "_h", w-h, r + "_hh");
+		double cpHH = getCriticalPath();
+		setCycleFromSignal(x + "_l", cpIn);
+		square(x + "_l", h, r + "_ll");
+		double cpLL = getCriticalPath();
+		setCycleFromSignal(x + "_l", cpIn);
+		IntMultiplier* cross = (IntMultiplier*) newInstance("IntMultiplier", r + "_cross", "wX=" + to_string(w-h) + " wY=" + to_string(h) + " wOut=0", "X=>" + x + "_h;Y=>" + x + "_l;R=>" + r + "_hl");
+		syncCycleFromSignal(r + "_hl");
+		setCriticalPath(cross->getOutputDelay("R"));
+		syncCycleFromSignal(r + "_hh", cpHH);
+		syncCycleFromSignal(r + "_ll", cpLL);
+
+		addComment("xh^2*2^(2h) + xl^2 is a concatenation, the cross product counts twice");
+		manageCriticalPath(getTarget()->localWireDelay() + getTarget()->adderDelay(2*w));
+		vhdl << tab << declare(r, 2*w) << " <= (" << r << "_hh & " << r << "_ll) + ("
+			<< zg(w-h-1) << " & " << r << "_hl & " << zg(h+1) << ");" << endl;
+	}
+
+
+	void PositSquare::emulate(TestCase * tc) {
+		mpz_class svX = tc->getInputValue ( "Input" );
+		tc->addExpectedOutput ( "Output", model.mult(svX, svX) );
+	}
+
+
+	OperatorPtr PositSquare::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		return new PositSquare(target, N, es);
+	}
+
+
+	void PositSquare::registerFactory(){
+		UserInterface::add("PositSquare", // name
+											 "A posit squarer, with a single decoder and a symmetric fraction squarer.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "Rounds to nearest even, as PositMult does for a product of equal inputs.",
+											 PositSquare::parseArguments
+											 ) ;
+	}
+
+}//namespace
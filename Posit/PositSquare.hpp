@@ -0,0 +1,79 @@
+/*
+  Posit squarer.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_SQUARE_HPP
+#define POSIT_SQUARE_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** The square of an N-bit posit, correctly rounded.
+	    Compared to PositMult with both inputs tied, there is a single decoder,
+	    the scale factor of the result is 2*SF + overflow without an adder, the
+	    sign is always 0, and the fraction is squared from its symmetric partial
+	    products: with x = xh*2^h + xl, x^2 = xh^2*2^(2h) + xh*xl*2^(h+1) + xl^2,
+	    the two half squares being split the same way down to small widths. */
+	class PositSquare : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+
+		int RegSize;
+		int FracSize;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** Declares r, the 2w-bit square of the w-bit signal x */
+		void square(string x, int w, string r);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    */
+		PositSquare(Target* target, int N = 8, int es = 1, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositSquare() {};
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator */
+		void emulate(TestCase * tc);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
@@ -0,0 +1,364 @@
+/* header of libraries to manipulate multiprecision numbers
+   There will be used in the emulate function to manipulate arbitraly large
+   entries */
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <stdio.h>
+
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "PositMult.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+
+// include the header of the Operator
+#include "PositStream.hpp"
+using namespace std;
+
+namespace flopoco {
+
+	PositStream::PositStream(Target* target, int N, int es, string opName, bool tlast, map<string, double> inputDelays) :
+	Operator(target), N(N), es(es), opName(opName), tlast(tlast), model(N, es) {
+
+		// definition of the source file name, used for info and error reporting using REPORT
+		srcFileName="PositStream";
+
+		// definition of the name of the operator
+		ostringstream name;
+		name << "PositStream_" << opName << "_" << N << "_" << es << (tlast ? "_tlast" : "");
+		setNameWithFreqAndUID(name.str());
+		// Copyright
+		setCopyrightString("Raul Murillo, 2019");
+
+		// the FIFO and the credit counter are registers whatever the target frequency
+		setSequential();
+
+		if(opName == "PositMult") {
+			subop = new PositMult(target, N, es);
+			inPorts = {"InputA", "InputB"};
+			outPorts = {"Output"};
+		}
+		else if(opName == "PositDecoder") {
+			subop = new PositDecoder(target, N, es);
+			inPorts = {"Input"};
+			outPorts = {"Sign", "Reg", "Exp", "Frac", "z", "inf"};
+		}
+		else if(opName == "PositEncoder") {
+			subop = new PositEncoder(target, N, es);
+			inPorts = {"Sign", "SF", "Frac", "z", "inf"};
+			outPorts = {"Output"};
+		}
+		else
+			THROWERROR("op must be PositMult, PositDecoder or PositEncoder, got " << opName);
+		addSubComponent(subop);
+
+		latency = subop->getPipelineDepth();
+		// L transfers in the pipeline, one in the FIFO, and one more so that s_axis_tready stays 1 at full rate
+		depth = latency + 2;
+		// A transfer leaves L+1 cycles after it enters at full rate, but the outputs
+		// are registered: the testbench checks each cycle against the previous ones
+		setPipelineDepth(0);
+		resetStream();
+
+		wIn = 0;
+		for(auto p : inPorts)
+			wIn += subop->getSignalByName(p)->width();
+		wOut = 0;
+		for(auto p : outPorts)
+			wOut += subop->getSignalByName(p)->width();
+
+		/* SET UP THE IO SIGNALS */
+		addInput  ( "s_axis_tvalid" );
+		addOutput ( "s_axis_tready" );
+		addInput  ( "s_axis_tdata", wIn );
+		if(tlast)
+			addInput  ( "s_axis_tlast" );
+		addOutput ( "m_axis_tvalid" );
+		addInput  ( "m_axis_tready" );
+		addOutput ( "m_axis_tdata", wOut );
+		if(tlast)
+			addOutput ( "m_axis_tlast" );
+
+		REPORT(INFO,"Declaration of PositStream \n");
+		REPORT(DETAILED, "this operator has received four parameters " << N << ", " << es << ", " << opName << " and " << tlast);
+		REPORT(DETAILED, opName << " has a latency of " << latency << " cycles, the FIFO has " << depth << " entries");
+	};
+
+
+	string PositStream::slice(string tdata, vector<string> &ports, int p) {
+		int lsb = 0;
+		for(int i = 0; i < p; i++)
+			lsb += subop->getSignalByName(ports[i])->width();
+		Signal* s = subop->getSignalByName(ports[p]);
+		ostringstream o;
+		o << tdata;
+		if(s->isBus() || s->width() > 1)
+			o << range(lsb+s->width()-1, lsb);
+		else
+			o << of(lsb);
+		return o.str();
+	}
+
+
+	void PositStream::outputVHDL(std::ostream& o, std::string name) {
+		int L = latency;
+		int wF = wOut + (tlast ? 1 : 0);
+		licence(o);
+		stdLibs(o);
+		outputVHDLEntity(o);
+		o << "architecture arch of " << name << " is" << endl;
+		subop->outputVHDLComponent(o);
+		for(auto p : inPorts)
+			o << tab << "signal op_" << p << " : " << subop->getSignalByName(p)->toVHDLType() << ";" << endl;
+		for(auto p : outPorts)
+			o << tab << "signal op_" << p << " : " << subop->getSignalByName(p)->toVHDLType() << ";" << endl;
+		o << tab << "type fifo_t is array(0 to " << depth-1 << ") of std_logic_vector(" << wF-1 << " downto 0);" << endl;
+		o << tab << "signal fifo : fifo_t;" << endl;
+		o << tab << "signal wr_ptr, rd_ptr : integer range 0 to " << depth-1 << ";" << endl;
+		o << tab << "-- transfers in the FIFO, and accepted transfers that have not left it" << endl;
+		o << tab << "signal count, credits : integer range 0 to " << depth << ";" << endl;
+		o << tab << "signal ready, accept, push, pop, valid : std_logic;" << endl;
+		o << tab << "signal vld : std_logic_vector(" << L << " downto 0);" << endl;
+		if(tlast)
+			o << tab << "signal lst : std_logic_vector(" << L << " downto 0);" << endl;
+		o << tab << "signal result : std_logic_vector(" << wF-1 << " downto 0);" << endl;
+		o << "begin" << endl;
+
+		o << tab << "ready <= '1' when credits < " << depth << " else '0';" << endl;
+		o << tab << "accept <= s_axis_tvalid and ready;" << endl;
+		o << tab << "s_axis_tready <= ready;" << endl << endl;
+
+		o << tab << "-- The operator computes every cycle, valid and tlast follow its pipeline" << endl;
+		for(unsigned p = 0; p < inPorts.size(); p++)
+			o << tab << "op_" << inPorts[p] << " <= " << slice("s_axis_tdata", inPorts, p) << ";" << endl;
+		o << tab << "op: " << subop->getName() << endl;
+		o << tab << tab << "port map (";
+		if(subop->isSequential())
+			o << "clk => clk, rst => rst, ";
+		for(auto p : inPorts)
+			o << p << " => op_" << p << ", ";
+		for(unsigned p = 0; p < outPorts.size(); p++)
+			o << outPorts[p] << " => op_" << outPorts[p] << (p+1 < outPorts.size() ? ", " : ");");
+		o << endl;
+		o << tab << "vld(0) <= accept;" << endl;
+		if(tlast)
+			o << tab << "lst(0) <= s_axis_tlast;" << endl;
+		if(L > 0) {
+			o << tab << "process(clk)" << endl;
+			o << tab << "begin" << endl;
+			o << tab << tab << "if rising_edge(clk) then" << endl;
+			o << tab << tab << tab << "if rst = '1' then" << endl;
+			o << tab << tab << tab << tab << "vld(" << L << " downto 1) <= (others => '0');" << endl;
+			o << tab << tab << tab << "else" << endl;
+			o << tab << tab << tab << tab << "vld(" << L << " downto 1) <= vld(" << L-1 << " downto 0);" << endl;
+			o << tab << tab << tab << "end if;" << endl;
+			if(tlast)
+				o << tab << tab << tab << "lst(" << L << " downto 1) <= lst(" << L-1 << " downto 0);" << endl;
+			o << tab << tab << "end if;" << endl;
+			o << tab << "end process;" << endl;
+		}
+		o << tab << "push <= vld(" << L << ");" << endl;
+		o << tab << "result <= ";
+		if(tlast)
+			o << "lst(" << L << ") & ";
+		for(int p = outPorts.size()-1; p >= 0; p--)
+			o << "op_" << outPorts[p] << (p > 0 ? " & " : ";");
+		o << endl << endl;
+
+		o << tab << "-- The FIFO cannot overflow: it has an entry for each credit" << endl;
+		o << tab << "valid <= '1' when count /= 0 else '0';" << endl;
+		o << tab << "pop <= valid and m_axis_tready;" << endl;
+		o << tab << "process(clk)" << endl;
+		o << tab << "begin" << endl;
+		o << tab << tab << "if rising_edge(clk) then" << endl;
+		o << tab << tab << tab << "if push = '1' then" << endl;
+		o << tab << tab << tab << tab << "fifo(wr_ptr) <= result;" << endl;
+		o << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << tab << "if rst = '1' then" << endl;
+		o << tab << tab << tab << tab << "wr_ptr <= 0;" << endl;
+		o << tab << tab << tab << tab << "rd_ptr <= 0;" << endl;
+		o << tab << tab << tab << tab << "count <= 0;" << endl;
+		o << tab << tab << tab << tab << "credits <= 0;" << endl;
+		o << tab << tab << tab << "else" << endl;
+		o << tab << tab << tab << tab << "if push = '1' then" << endl;
+		o << tab << tab << tab << tab << tab << "if wr_ptr = " << depth-1 << " then wr_ptr <= 0; else wr_ptr <= wr_ptr + 1; end if;" << endl;
+		o << tab << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << tab << tab << "if pop = '1' then" << endl;
+		o << tab << tab << tab << tab << tab << "if rd_ptr = " << depth-1 << " then rd_ptr <= 0; else rd_ptr <= rd_ptr + 1; end if;" << endl;
+		o << tab << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << tab << tab << "if push = '1' and pop = '0' then" << endl;
+		o << tab << tab << tab << tab << tab << "count <= count + 1;" << endl;
+		o << tab << tab << tab << tab << "elsif push = '0' and pop = '1' then" << endl;
+		o << tab << tab << tab << tab << tab << "count <= count - 1;" << endl;
+		o << tab << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << tab << tab << "if accept = '1' and pop = '0' then" << endl;
+		o << tab << tab << tab << tab << tab << "credits <= credits + 1;" << endl;
+		o << tab << tab << tab << tab << "elsif accept = '0' and pop = '1' then" << endl;
+		o << tab << tab << tab << tab << tab << "credits <= credits - 1;" << endl;
+		o << tab << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << tab << "end if;" << endl;
+		o << tab << tab << "end if;" << endl;
+		o << tab << "end process;" << endl;
+		o << tab << "m_axis_tvalid <= valid;" << endl;
+		o << tab << "m_axis_tdata <= fifo(rd_ptr)(" << wOut-1 << " downto 0);" << endl;
+		if(tlast)
+			o << tab << "m_axis_tlast <= fifo(rd_ptr)(" << wOut << ");" << endl;
+		o << "end architecture;" << endl << endl;
+	}
+
+
+	void PositStream::resetStream() {
+		pipeValid.assign(latency, false);
+		pipeResult.assign(latency, mpz_class(0));
+		fifo.assign(depth, mpz_class(0));
+		wrPtr = 0;
+		rdPtr = 0;
+		count = 0;
+		credits = 0;
+		nextTest = 0;
+	}
+
+
+	mpz_class PositStream::result(mpz_class in, bool last) {
+		vector<mpz_class> x;
+		for(auto p : inPorts) {
+			int w = subop->getSignalByName(p)->width();
+			x.push_back(in & ((mpz_class(1) << w) - 1));
+			in >>= w;
+		}
+
+		vector<mpz_class> r;
+		if(opName == "PositMult")
+			r.push_back(model.mult(x[0], x[1]));
+		else if(opName == "PositDecoder") {
+			if(N > 64)
+				THROWERROR("emulate is only available for N <= 64");
+			uint64_t out[6];
+			((PositDecoder*) subop)->decodeOutputs(mpz_get_ui(x[0].get_mpz_t()), out);
+			for(int j = 0; j < 6; j++)
+				r.push_back(mpz_class((unsigned long) out[j]));
+		}
+		else
+			r.push_back(((PositEncoder*) subop)->encode(x[0], x[1], x[2], x[3], x[4]));
+
+		mpz_class out = 0;
+		int lsb = 0;
+		for(unsigned p = 0; p < outPorts.size(); p++) {
+			out += r[p] << lsb;
+			lsb += subop->getSignalByName(outPorts[p])->width();
+		}
+		if(last)
+			out += mpz_class(1) << wOut;
+		return out;
+	}
+
+
+	void PositStream::emulate(TestCase * tc) {
+		// The outputs only depend on the registers
+		bool ready = (credits < depth);
+		bool valid = (count != 0);
+		tc->addExpectedOutput("s_axis_tready", mpz_class(ready ? 1 : 0));
+		tc->addExpectedOutput("m_axis_tvalid", mpz_class(valid ? 1 : 0));
+		// m_axis_tdata is not checked while m_axis_tvalid is 0
+		if(valid) {
+			mpz_class head = fifo[rdPtr];
+			tc->addExpectedOutput("m_axis_tdata", head & ((mpz_class(1) << wOut) - 1));
+			if(tlast)
+				tc->addExpectedOutput("m_axis_tlast", head >> wOut);
+		}
+
+		// The clock edge at the end of the cycle
+		bool accept = ready && tc->getInputValue("s_axis_tvalid") != 0;
+		bool pop = valid && tc->getInputValue("m_axis_tready") != 0;
+		bool push = accept;
+		mpz_class res = result(tc->getInputValue("s_axis_tdata"), tlast && tc->getInputValue("s_axis_tlast") != 0);
+		if(latency > 0) {
+			// the operator computes every cycle: only the valid results are pushed
+			pipeValid.insert(pipeValid.begin(), accept);
+			pipeResult.insert(pipeResult.begin(), res);
+			push = pipeValid.back();
+			res = pipeResult.back();
+			pipeValid.pop_back();
+			pipeResult.pop_back();
+		}
+		if(push) {
+			fifo[wrPtr] = res;
+			wrPtr = (wrPtr + 1) % depth;
+		}
+		if(pop)
+			rdPtr = (rdPtr + 1) % depth;
+		count += (push ? 1 : 0) - (pop ? 1 : 0);
+		credits += (accept ? 1 : 0) - (pop ? 1 : 0);
+		nextTest++;
+	}
+
+
+	TestCase* PositStream::buildRandomTestCase(int i) {
+		// the wrapped operator biases its own inputs
+		TestCase *stc = subop->buildRandomTestCase(i);
+		mpz_class in = 0;
+		int lsb = 0;
+		for(auto p : inPorts) {
+			in += stc->getInputValue(p) << lsb;
+			lsb += subop->getSignalByName(p)->width();
+		}
+		delete stc;
+
+		// The tests are consecutive cycles of one stream
+		if(i == 0)
+			resetStream();
+		else if(i != nextTest)
+			THROWERROR("the random tests must be built in order: expected test " << nextTest << ", got " << i);
+
+		// Both sides are ready 3 cycles out of 4, and in every other run of 64 cycles
+		// the master only 1 out of 4, so that the FIFO fills up and s_axis_tready falls
+		bool slowMaster = ((i / 64) % 2 == 1);
+		TestCase *tc = new TestCase(this);
+		tc->addInput("s_axis_tvalid", mpz_class(getLargeRandom(2) != 0 ? 1 : 0));
+		tc->addInput("s_axis_tdata", in);
+		if(tlast)
+			tc->addInput("s_axis_tlast", mpz_class(i % 16 == 15 ? 1 : 0));
+		tc->addInput("m_axis_tready", mpz_class((getLargeRandom(2) != 0) != slowMaster ? 1 : 0));
+		emulate(tc);
+		return tc;
+	}
+
+
+	OperatorPtr PositStream::parseArguments(Target *target, vector<string> &args) {
+		int N;
+		UserInterface::parseStrictlyPositiveInt(args, "N", &N);
+		int es;
+		UserInterface::parsePositiveInt(args, "es", &es);
+		string op;
+		UserInterface::parseString(args, "op", &op);
+		bool tlast;
+		UserInterface::parseBoolean(args, "tlast", &tlast);
+		return new PositStream(target, N, es, op, tlast);
+	}
+
+
+	void PositStream::registerFactory(){
+		UserInterface::add("PositStream", // name
+											 "A posit operator behind AXI4-Stream interfaces, with valid/ready backpressure.", // description, string
+											 "Posit", // category, from the list defined in UserInterface.cpp
+											 "PositMult,PositDecoder,PositEncoder", //seeAlso
+											 // Now comes the parameter description string.
+											 // Respect its syntax because it will be used to generate the parser and the docs
+											 // Syntax is: a semicolon-separated list of parameterDescription;
+											 // where parameterDescription is parameterName (parameterType)[=defaultValue]: parameterDescriptionString
+											 "N(int)=8: The input size; \
+                        					 es(int): The exponent size; \
+                        					 op(string)=PositMult: The wrapped operator, PositMult, PositDecoder or PositEncoder; \
+                        					 tlast(bool)=false: Pass tlast along with the data",
+											 // More documentation for the HTML pages. If you want to link to your blog, it is here.
+											 "The operator inputs are packed in s_axis_tdata and its outputs in m_axis_tdata, the first port in the LSBs. The active-high rst resets the handshake logic.",
+											 PositStream::parseArguments
+											 ) ;
+	}
+
+}//namespace
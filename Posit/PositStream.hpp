@@ -0,0 +1,125 @@
+/*
+  AXI4-Stream wrapper of the posit operators.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_STREAM_HPP
+#define POSIT_STREAM_HPP
+
+#include <vector>
+#include <sstream>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "Operator.hpp"
+#include "../Target.hpp"
+#include "PositModel.hpp"
+
+/* This file contains a lot of useful functions to manipulate vhdl */
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** A PositMult, PositDecoder or PositEncoder behind AXI4-Stream slave and
+	    master interfaces. The inputs of the operator are packed in s_axis_tdata
+	    and its outputs in m_axis_tdata, the first port in the LSBs.
+	    The operator itself is never stalled: a valid bit (and tlast) travels
+	    along its pipeline, and the results are written in a FIFO of L+2 entries,
+	    L being the latency of the operator. s_axis_tready is 1 as long as fewer
+	    than L+2 accepted transfers have not left the FIFO, so results are never
+	    lost, and one transfer per cycle is sustained when m_axis_tready is 1. */
+	class PositStream : public Operator {
+	private:
+		/** The total width of the posits */
+		int N;
+		/** The width of the exponent */
+		int es;
+		/** The wrapped operator: PositMult, PositDecoder or PositEncoder */
+		string opName;
+		/** Pass tlast along with the data */
+		bool tlast;
+
+		/** The wrapped operator, and its latency */
+		Operator* subop;
+		int latency;
+		/** Number of FIFO entries, also the number of transfers in flight */
+		int depth;
+
+		/** Ports of the wrapped operator, in their order in tdata */
+		vector<string> inPorts;
+		vector<string> outPorts;
+		/** Widths of tdata */
+		int wIn;
+		int wOut;
+
+		/** Software model used by emulate */
+		PositModel model;
+
+		/** State of the stream between consecutive test cases, as in the VHDL:
+		    the valid bits and results along the pipeline of the operator, the
+		    FIFO, its pointers and counters, and the index of the next test */
+		vector<bool> pipeValid;
+		vector<mpz_class> pipeResult;
+		vector<mpz_class> fifo;
+		int wrPtr;
+		int rdPtr;
+		int count;
+		int credits;
+		int nextTest;
+
+		/** Back to the state after rst */
+		void resetStream();
+
+		/** The m_axis_tdata (and tlast, on top) of the transfer of s_axis_tdata in */
+		mpz_class result(mpz_class in, bool last);
+
+		/** The slice of tdata holding port p of the wrapped operator */
+		string slice(string tdata, vector<string> &ports, int p);
+
+
+	public:
+		/** The constructor
+		    * @param N The size of the posits.
+		    * @param es The width of the exponent.
+		    * @param opName The wrapped operator: PositMult, PositDecoder or PositEncoder.
+		    * @param tlast Add s_axis_tlast and m_axis_tlast.
+		    */
+		PositStream(Target* target, int N = 8, int es = 1, string opName = "PositMult", bool tlast = false, map<string, double> inputDelays = emptyDelayMap);
+
+		// destructor
+		~PositStream() {};
+
+		/** The architecture is written here, as the FIFO is an array */
+		void outputVHDL(std::ostream& o, std::string name);
+
+
+		/* the emulate function is used to simulate in software the operator
+		   in order to compare this result with those outputed by the vhdl opertator.
+		   Each test case is a clock cycle, following the previous one: its expected
+		   outputs are those left by the previous cycles, then its inputs are applied */
+		void emulate(TestCase * tc);
+
+		/* function used to bias the (uniform by default) random test generator
+		   The input data are those of the wrapped operator, s_axis_tvalid and
+		   m_axis_tready are random so that both sides stall. Test 0 starts after rst */
+		TestCase* buildRandomTestCase(int i);
+
+		/** Factory method that parses arguments and calls the constructor */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	};
+
+}//namespace
+
+
+#endif
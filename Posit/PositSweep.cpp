@@ -0,0 +1,250 @@
+/* Parameter sweep of PositMult and PositDecoder.
+   Generates each (operator, N, es, target, frequency) point, and writes one CSV
+   line per point: the generation time, the estimated pipeline depth, critical
+   path and resources of PositReport, and the throughput of the test vector
+   generation (emulate).
+   The points run in parallel, each in its own process, as the FloPoCo globals
+   (unique identifiers, signal tables) are not shared between threads.
+   Link it with the FloPoCo library, without src/main.cpp: it registers the
+   factories itself, as the operators build their components with newInstance.
+
+   Usage: posit_sweep [out=sweep.csv] [jobs=0] [tests=100000]
+                      [ops=PositMult,PositDecoder] [N=8,16,24,32,64] [es=0,1,2,3,4]
+                      [targets=Virtex6,Kintex7] [frequencies=200,400]
+   jobs=0 uses all the cores. */
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Operator.hpp"
+#include "UserInterface.hpp"
+#include "../ShiftersEtc/LZOC.hpp"
+#include "../ShiftersEtc/Shifters.hpp"
+#include "../ShiftersEtc/Shifters_signed.hpp"
+#include "../IntAddSubCmp/IntAdder.hpp"
+#include "../IntMult/IntMultiplier.hpp"
+#include "../Targets/Virtex6.hpp"
+#include "../Targets/Kintex7.hpp"
+#include "../Targets/StratixV.hpp"
+#include "../Targets/Zynq7000.hpp"
+#include "PositDecoder.hpp"
+#include "PositEncoder.hpp"
+#include "PositMult.hpp"
+#include "PositMultROM.hpp"
+#include "PositReport.hpp"
+using namespace std;
+using namespace flopoco;
+
+namespace {
+
+	struct SweepPoint {
+		string op;
+		int N;
+		int es;
+		string target;
+		int frequency;
+	};
+
+
+	vector<string> splitList(string s) {
+		vector<string> r;
+		istringstream in(s);
+		string item;
+		while(getline(in, item, ','))
+			if(!item.empty())
+				r.push_back(item);
+		return r;
+	}
+
+
+	Target* makeTarget(string name) {
+		if(name == "Virtex6")
+			return new Virtex6();
+		if(name == "Kintex7")
+			return new Kintex7();
+		if(name == "StratixV")
+			return new StratixV();
+		if(name == "Zynq7000")
+			return new Zynq7000();
+		throw string("unknown target " + name + ", expected Virtex6, Kintex7, StratixV or Zynq7000");
+	}
+
+
+	/** Register the factories of the operators and of the components they
+	    instantiate, as main.cpp does for flopoco */
+	void registerFactories() {
+		Shifter::registerFactory();
+		Shifter_signed::registerFactory();
+		LZOC::registerFactory();
+		IntAdder::registerFactory();
+		IntMultiplier::registerFactory();
+		PositDecoder::registerFactory();
+		PositEncoder::registerFactory();
+		PositMultROM::registerFactory();
+		PositMult::registerFactory();
+	}
+
+
+	const char* csvHeader = "operator,N,es,target,frequency_mhz,generation_ms,pipeline_depth,critical_path_ns,luts,dsps,registers,emulate_per_s,error";
+
+
+	/** Generate one point and return its CSV line, without the newline */
+	string runPoint(const SweepPoint& p, int tests) {
+		ostringstream row;
+		row << p.op << "," << p.N << "," << p.es << "," << p.target << "," << p.frequency << ",";
+		try {
+			Target* target = makeTarget(p.target);
+			target->setFrequency(p.frequency * 1e6);
+
+			// a single test vector thread: the points already use all the cores
+			auto start = chrono::steady_clock::now();
+			Operator* op;
+			const PositReport* report;
+			if(p.op == "PositMult") {
+				PositMult* mult = new PositMult(target, p.N, p.es, false, 1);
+				report = &mult->getReport();
+				op = mult;
+			}
+			else if(p.op == "PositDecoder") {
+				PositDecoder* decoder = new PositDecoder(target, p.N, p.es, 1);
+				report = &decoder->getReport();
+				op = decoder;
+			}
+			else
+				throw string("unknown operator " + p.op + ", expected PositMult or PositDecoder");
+			double genTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+			start = chrono::steady_clock::now();
+			for(int i = 0; i < tests; i++)
+				delete op->buildRandomTestCase(i);
+			double emuTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+			row << genTime*1e3 << "," << report->depth() << "," << report->criticalPath()*1e9 << ","
+				<< report->luts() << "," << report->dsps() << "," << report->registers() << ","
+				<< (emuTime > 0 ? tests / emuTime : 0) << ",";
+		}
+		catch(string s) {
+			// commas would split the field
+			for(char& c : s)
+				if(c == ',' || c == '\n')
+					c = ' ';
+			row << ",,,,,,," << s;
+		}
+		return row.str();
+	}
+
+}
+
+
+int main(int argc, char* argv[]) {
+	string out = "sweep.csv";
+	int jobs = 0;
+	int tests = 100000;
+	vector<string> ops = {"PositMult", "PositDecoder"};
+	vector<string> Ns = {"8", "16", "24", "32", "64"};
+	vector<string> ess = {"0", "1", "2", "3", "4"};
+	vector<string> targets = {"Virtex6", "Kintex7"};
+	vector<string> frequencies = {"200", "400"};
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		size_t eq = arg.find('=');
+		string key = arg.substr(0, eq);
+		string val = (eq == string::npos ? "" : arg.substr(eq+1));
+		if(key == "out") out = val;
+		else if(key == "jobs") jobs = stoi(val);
+		else if(key == "tests") tests = stoi(val);
+		else if(key == "ops") ops = splitList(val);
+		else if(key == "N") Ns = splitList(val);
+		else if(key == "es") ess = splitList(val);
+		else if(key == "targets") targets = splitList(val);
+		else if(key == "frequencies") frequencies = splitList(val);
+		else {
+			cerr << "unknown argument " << arg << endl;
+			return 1;
+		}
+	}
+	if(jobs <= 0)
+		jobs = max(1u, thread::hardware_concurrency());
+
+	// before the fork, so that every worker inherits them
+	UserInterface::initialize();
+	registerFactories();
+
+	vector<SweepPoint> points;
+	for(string op : ops)
+		for(string N : Ns)
+			for(string es : ess)
+				for(string target : targets)
+					for(string f : frequencies)
+						points.push_back({op, stoi(N), stoi(es), target, stoi(f)});
+
+	// Each point runs in a child process, which sends its CSV line through a pipe
+	struct Job {
+		pid_t pid;
+		int fd;
+		size_t index;
+	};
+	vector<string> rows(points.size());
+	vector<Job> running;
+	size_t next = 0;
+	size_t done = 0;
+	while(next < points.size() || !running.empty()) {
+		while(next < points.size() && (int)running.size() < jobs) {
+			int fds[2];
+			if(pipe(fds) != 0) {
+				cerr << "pipe failed" << endl;
+				return 1;
+			}
+			pid_t pid = fork();
+			if(pid == 0) {
+				close(fds[0]);
+				string row = runPoint(points[next], tests);
+				if(write(fds[1], row.data(), row.size()) < 0)
+					_exit(1);
+				_exit(0);
+			}
+			close(fds[1]);
+			running.push_back({pid, fds[0], next});
+			next++;
+		}
+
+		int status;
+		pid_t pid = wait(&status);
+		for(size_t j = 0; j < running.size(); j++) {
+			if(running[j].pid != pid)
+				continue;
+			string row;
+			char buf[4096];
+			ssize_t n;
+			while((n = read(running[j].fd, buf, sizeof(buf))) > 0)
+				row.append(buf, n);
+			close(running[j].fd);
+			const SweepPoint& p = points[running[j].index];
+			if(row.empty()) {
+				// the worker crashed before reporting
+				ostringstream r;
+				r << p.op << "," << p.N << "," << p.es << "," << p.target << "," << p.frequency << ",,,,,,,,worker exited with status " << status;
+				row = r.str();
+			}
+			rows[running[j].index] = row;
+			done++;
+			cerr << "[" << done << "/" << points.size() << "] " << row << endl;
+			running.erase(running.begin() + j);
+			break;
+		}
+	}
+
+	ofstream f(out);
+	f << csvHeader << endl;
+	for(string& row : rows)
+		f << row << endl;
+	cerr << "Wrote " << points.size() << " points to " << out << endl;
+	return 0;
+}
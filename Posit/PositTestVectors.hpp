@@ -0,0 +1,161 @@
+/*
+  Parallel generation of test vectors for the posit operators.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_TEST_VECTORS_HPP
+#define POSIT_TEST_VECTORS_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <stdint.h>
+#include <gmpxx.h>
+
+#include "utils.hpp"
+
+
+namespace flopoco {
+
+	/** Test vectors are generated in batches of this many test cases */
+	static const uint64_t positTestBatchSize = 1 << 16;
+
+	/** Helpers to compute batches of test vectors on several cores.
+	    Test i only depends on i (inputs come from a counter-based generator),
+	    so the output is the same whatever the number of threads. */
+	class PositTestVectors {
+	public:
+		/** Number of worker threads to use when 0 is requested */
+		static int defaultThreads() {
+			int n = std::thread::hardware_concurrency();
+			return (n > 0 ? n : 1);
+		}
+
+		/** Uniformly distributed bits for test i, from the splitmix64 generator
+		    * @param stream Selects an independent sequence, e.g. one per input.
+		    */
+		static uint64_t randomBits(uint64_t i, int stream, int bits) {
+			uint64_t z = (i * 2 + stream + 1) * 0x9E3779B97F4A7C15ULL;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z = z ^ (z >> 31);
+			return (bits >= 64 ? z : z & ((((uint64_t)1) << bits) - 1));
+		}
+
+		/** A value of the ES input of a varEs operator, uniform in [0, es] */
+		static mpz_class randomEs(int es) {
+			mpz_class e;
+			do
+				e = getLargeRandom(intlog2(es));
+			while(e > es);
+			return e;
+		}
+	};
+
+
+	/** Worker threads started once and reused by every batch of test vectors,
+	    instead of being spawned again for each batch */
+	class PositThreadPool {
+	public:
+		/** The constructor
+		    * @param threads The number of threads, the calling one included, 0 for all cores.
+		    */
+		PositThreadPool(int threads) : generation(0), busy(0), stop(false), job(NULL) {
+			nThreads = (threads > 0 ? threads : PositTestVectors::defaultThreads());
+			for(int t=1; t<nThreads; t++)
+				workers.push_back(std::thread([this, t]() {work(t);}));
+		}
+
+		~PositThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(m);
+				stop = true;
+			}
+			start.notify_all();
+			for(size_t t=0; t<workers.size(); t++)
+				workers[t].join();
+		}
+
+		int size() const {return nThreads;}
+
+		/** Call f(i) for every i in [first, first+count), splitting the range in
+		    one contiguous chunk per thread, the calling thread taking the first one.
+		    f must only write to slots owned by i. */
+		template <class F>
+		void parallelFor(uint64_t first, uint64_t count, F f) {
+			uint64_t chunk = (count + nThreads - 1) / nThreads;
+			std::function<void(int)> chunkJob = [first, count, chunk, &f](int t) {
+				uint64_t lo = first + t*chunk;
+				uint64_t hi = (lo + chunk < first + count ? lo + chunk : first + count);
+				for(uint64_t i=lo; i<hi; i++)
+					f(i);
+			};
+			run(chunkJob);
+		}
+
+	private:
+		/** Run job(t) on every thread t, and wait for all of them */
+		void run(const std::function<void(int)>& j) {
+			if(nThreads == 1) {
+				j(0);
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(m);
+				job = &j;
+				busy = nThreads-1;
+				generation++;
+			}
+			start.notify_all();
+			j(0);
+			std::unique_lock<std::mutex> lock(m);
+			finished.wait(lock, [this]() {return busy == 0;});
+			job = NULL;
+		}
+
+		void work(int t) {
+			uint64_t seen = 0;
+			while(true) {
+				const std::function<void(int)>* j;
+				{
+					std::unique_lock<std::mutex> lock(m);
+					start.wait(lock, [this, seen]() {return stop || generation != seen;});
+					if(stop)
+						return;
+					seen = generation;
+					j = job;
+				}
+				(*j)(t);
+				{
+					std::lock_guard<std::mutex> lock(m);
+					busy--;
+				}
+				finished.notify_one();
+			}
+		}
+
+		int nThreads;
+		std::vector<std::thread> workers;
+		std::mutex m;
+		std::condition_variable start;
+		std::condition_variable finished;
+		/** Incremented for each job, so that a worker runs it once */
+		uint64_t generation;
+		/** Workers still running the current job */
+		int busy;
+		bool stop;
+		const std::function<void(int)>* job;
+	};
+
+}//namespace
+
+
+#endif
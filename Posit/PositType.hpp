@@ -0,0 +1,214 @@
+/*
+  Header-only posit<N,es> arithmetic, rounding as the PositMult hardware.
+
+  Author : Raul Murillo Montero
+
+  Initial software.
+  Copyright ©
+  2019.
+  All rights reserved.
+
+*/
+#ifndef POSIT_TYPE_HPP
+#define POSIT_TYPE_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+
+namespace flopoco {
+
+	/** An N-bit posit with es exponent bits, 3 <= N <= 64, for host code and emulate.
+	    Decoding, encoding and the product are constexpr and follow the rounding of
+	    PositMult bit for bit: round to nearest even on the bits cut by the
+	    regime, a scale factor beyond the longest regime saturating to maxpos or
+	    minpos, never to zero or NaR.
+	    Everything is specialized at compile time: the regime is counted with
+	    __builtin_clzll and each special case is a select, without data-dependent
+	    branches. Up to N = 32 the significands are 32-bit words and their product
+	    is a 64-bit word; above, a 64-bit word and an unsigned __int128 product.
+	    The functions are single return statements, as C++11 constexpr requires. */
+	template <int N, int es>
+	class posit {
+		static_assert(N >= 3 && N <= 64, "posit<N,es> needs 3 <= N <= 64");
+		static_assert(es >= 0 && es <= 16, "posit<N,es> needs 0 <= es <= 16");
+
+	public:
+		/** A significand with the hidden bit as MSB: the N-3 fraction bits at most fit below it */
+		typedef typename std::conditional<(N <= 32), uint32_t, uint64_t>::type sig_t;
+		/** The exact product of two significands */
+		typedef typename std::conditional<(N <= 32), uint64_t, unsigned __int128>::type wide_t;
+		static const int sigBits = 8 * sizeof(sig_t);
+
+		/** An unpacked posit, value (-1)^sign * sig * 2^(sf-sigBits+1) */
+		struct unpacked {
+			bool sign;
+			bool zero;
+			bool nar;
+			int sf;
+			sig_t sig;
+		};
+
+		constexpr posit() : bits(0) {}
+
+		/** The posit of an N-bit pattern, the bits above N being ignored */
+		static constexpr posit fromBits(uint64_t x) {return posit(x & mask(), 0);}
+		constexpr uint64_t getBits() const {return bits;}
+
+		static constexpr posit zero() {return posit(0, 0);}
+		static constexpr posit nar() {return posit(narBits(), 0);}
+		static constexpr posit maxpos() {return posit(narBits()-1, 0);}
+		static constexpr posit minpos() {return posit(1, 0);}
+
+		constexpr bool isZero() const {return bits == 0;}
+		constexpr bool isNaR() const {return bits == narBits();}
+
+		/** Sign, scale factor and significand, as PositDecoder */
+		constexpr unpacked decode() const {return decodeBody(bits, signOf(bits), absBits(bits) << (65-N));}
+
+		/** Round and pack (-1)^sign * (1+frac*2^-64) * 2^sf, as PositEncoder
+		    * @param frac The fraction bits after the hidden bit, left-aligned.
+		    * @param sticky true when nonzero bits follow frac.
+		    */
+		static constexpr posit encode(bool sign, int sf, uint64_t frac, bool sticky) {
+			return encodeRegime(sign, sf, frac, sticky, clamp(sf >> es));
+		}
+
+		/** The rounded product, as PositMult */
+		constexpr posit operator*(posit b) const {return mult(decode(), b.decode());}
+
+		constexpr bool operator==(posit b) const {return bits == b.bits;}
+		constexpr bool operator!=(posit b) const {return bits != b.bits;}
+
+		/** The closest posit to a double, NaN and infinities giving NaR */
+		static posit fromDouble(double d) {
+			uint64_t u;
+			memcpy(&u, &d, sizeof(u));
+			int e = (int)((u >> 52) & 0x7ff);
+			uint64_t f = u & ((((uint64_t)1) << 52) - 1);
+			if(e == 0x7ff)
+				return nar();
+			if(e == 0 && f == 0)
+				return zero();
+			if(e == 0) {
+				// subnormal: normalize the fraction
+				int lz = __builtin_clzll(f);
+				return encode(u >> 63, -1011 - lz, f << lz << 1, false);
+			}
+			return encode(u >> 63, e - 1023, f << 12, false);
+		}
+
+		/** The posit as a double, rounded above 53 significand bits */
+		double toDouble() const {
+			unpacked v = decode();
+			if(v.nar)
+				return NAN;
+			if(v.zero)
+				return 0.0;
+			double m = ldexp((double)v.sig, v.sf - (sigBits-1));
+			return (v.sign ? -m : m);
+		}
+
+	private:
+		uint64_t bits;
+
+		constexpr posit(uint64_t x, int) : bits(x) {}
+
+		static constexpr uint64_t mask() {return ~((uint64_t)0) >> (64-N);}
+		static constexpr uint64_t narBits() {return ((uint64_t)1) << (N-1);}
+		static constexpr uint64_t signOf(uint64_t x) {return (x >> (N-1)) & 1;}
+		/** x if s is 0, its 2's complement on N bits if s is 1 */
+		static constexpr uint64_t negateIf(uint64_t x, uint64_t s) {return ((x ^ (0 - s)) + s) & mask();}
+		static constexpr uint64_t absBits(uint64_t x) {return negateIf(x, signOf(x));}
+
+		// Decoding, body being the N-1 bits after the sign, left-aligned
+		/** The length of the regime run: a stop bit after the body bounds it by N-1 */
+		static constexpr int runLength(uint64_t body) {
+			return __builtin_clzll((body ^ (0 - (body >> 63))) | (((uint64_t)1) << (64-N)));
+		}
+		static constexpr unpacked decodeBody(uint64_t x, uint64_t s, uint64_t body) {
+			return decodeRun(x, s, (int)(body >> 63), runLength(body), body);
+		}
+		static constexpr unpacked decodeRun(uint64_t x, uint64_t s, int rc, int run, uint64_t body) {
+			// the exponent and the fraction, left-aligned after the regime and its stop bit
+			return decodeFields(x, s, (rc ? run-1 : -run), body << run << 1);
+		}
+		static constexpr unpacked decodeFields(uint64_t x, uint64_t s, int k, uint64_t rest) {
+			return unpacked{s != 0, x == 0, x == narBits(), k * (1 << es) + (int)(rest >> (63-es) >> 1),
+					(sig_t)(((((uint64_t)1) << 63) | (rest << es >> 1)) >> (64-sigBits))};
+		}
+
+		// Encoding
+		/** The regime value, within the longest regimes */
+		static constexpr int clamp(int k) {return (k > N-2 ? N-2 : (k < -(N-2) ? -(N-2) : k));}
+		static constexpr posit encodeRegime(bool sign, int sf, uint64_t frac, bool sticky, int k) {
+			// k+1 ones and a zero, or -k zeros and a one, left-aligned
+			return encodeLength(sign, sf, frac, sticky,
+					(k >= 0 ? ~(~((uint64_t)0) >> (k+1)) : ((uint64_t)1) << (63+k)), (k >= 0 ? k+2 : 1-k));
+		}
+		static constexpr posit encodeLength(bool sign, int sf, uint64_t frac, bool sticky, uint64_t regime, int len) {
+			// the exponent and the fraction follow the regime; the bits shifted out of both are sticky
+			return encodeString(sign, sf,
+					regime | ((((uint64_t)(sf & ((1 << es) - 1))) << (63-es) << 1) >> (len-1) >> 1) | (frac >> es >> (len-1) >> 1),
+					sticky || (frac & (~((uint64_t)0) >> (64 - (es+len > 64 ? 64 : es+len)))) != 0
+						|| (sf & ((1 << (es+len > 64 ? es+len-64 : 0)) - 1)) != 0);
+		}
+		static constexpr posit encodeString(bool sign, int sf, uint64_t str, bool sticky) {
+			// N-1 bits of body, then the guard bit, the bits below being sticky
+			return encodeRound(sign, sf, str >> (65-N), (str >> (64-N)) & 1, sticky || (str << (N-1) << 1) != 0);
+		}
+		static constexpr posit encodeRound(bool sign, int sf, uint64_t body, uint64_t guard, bool sticky) {
+			// round to nearest even; below the shortest regime the clamped one would round, minpos is kept
+			return posit(negateIf(((sf >> es) < -(N-2) ? 1 : body + (guard & ((body & 1) | (uint64_t)sticky))), sign), 0);
+		}
+
+		// Product
+		static constexpr posit mult(unpacked a, unpacked b) {
+			return (a.nar || b.nar ? nar() : (a.zero || b.zero ? zero() :
+					multProduct(a.sign != b.sign, a.sf + b.sf, ((wide_t)a.sig) * b.sig)));
+		}
+		static constexpr posit multProduct(bool sign, int sf, wide_t p) {
+			// a product in [2,4) adds one to the scale factor; the hidden bit is then shifted out
+			return multFraction(sign, sf + (int)(p >> (2*sigBits-1)), p << (1 - (int)(p >> (2*sigBits-1))) << 1);
+		}
+		static constexpr posit multFraction(bool sign, int sf, wide_t f) {
+			return encode(sign, sf, (uint64_t)(f >> (2*sigBits-64)), (f - (((wide_t)(uint64_t)(f >> (2*sigBits-64))) << (2*sigBits-64))) != 0);
+		}
+	};
+
+
+	/** The product of two N-bit patterns with posit<N,es> */
+	template <int N, int es>
+	uint64_t positMultBits(uint64_t a, uint64_t b) {
+		return (posit<N,es>::fromBits(a) * posit<N,es>::fromBits(b)).getBits();
+	}
+
+	typedef uint64_t (*PositMultFunction)(uint64_t, uint64_t);
+
+	/** positMultBits for a format chosen at run time, up to es = 4 */
+	template <int N, int es>
+	struct PositMultDispatch {
+		static PositMultFunction get(int n, int e) {
+			return (n == N && e == es ? &positMultBits<N,es> : PositMultDispatch<N, es-1>::get(n, e));
+		}
+	};
+	template <int N>
+	struct PositMultDispatch<N, -1> {
+		static PositMultFunction get(int n, int e) {return PositMultDispatch<N-1, 4>::get(n, e);}
+	};
+	template <>
+	struct PositMultDispatch<2, 4> {
+		static PositMultFunction get(int, int) {return NULL;}
+	};
+
+	/** The product of posit<N,es> on bit patterns, NULL outside 3 <= N <= 64 and es <= 4 */
+	inline PositMultFunction positMultFunction(int N, int es) {
+		return PositMultDispatch<64, 4>::get(N, es);
+	}
+
+}//namespace
+
+
+#endif